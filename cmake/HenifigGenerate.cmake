@@ -0,0 +1,59 @@
+##########################################################################
+# Copyright 2025 Ramskyi Roman
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+# http://www.apache.org/licenses/LICENSE-2.0
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+##########################################################################
+
+# henifig_generate(<target> <sample.hfg> [NAMESPACE <name>] [STRUCT <name>] [OUTPUT <header>])
+#
+# Generates a header with a struct of the shape of the sample config and a loader filling it,
+# and adds it to the target. The header is named after the sample unless OUTPUT says otherwise
+# and is included by its name alone. henifig-gen is taken from its target when it's part of the build,
+# from HENIFIG_GEN_EXECUTABLE otherwise.
+function(henifig_generate target sample)
+    cmake_parse_arguments(HENIFIG_GEN "" "NAMESPACE;STRUCT;OUTPUT" "" ${ARGN})
+    get_filename_component(sample "${sample}" ABSOLUTE)
+    get_filename_component(sample_name "${sample}" NAME_WE)
+    if (NOT HENIFIG_GEN_OUTPUT)
+        set(HENIFIG_GEN_OUTPUT "${sample_name}.hpp")
+    endif()
+    set(output_dir "${CMAKE_CURRENT_BINARY_DIR}/henifig_generated")
+    set(output "${output_dir}/${HENIFIG_GEN_OUTPUT}")
+
+    if (TARGET henifig-gen)
+        set(generator $<TARGET_FILE:henifig-gen>)
+        set(generator_dependency henifig-gen)
+    elseif (HENIFIG_GEN_EXECUTABLE)
+        set(generator ${HENIFIG_GEN_EXECUTABLE})
+        set(generator_dependency ${HENIFIG_GEN_EXECUTABLE})
+    else()
+        message(FATAL_ERROR "henifig_generate: there's no henifig-gen target and HENIFIG_GEN_EXECUTABLE isn't set")
+    endif()
+
+    set(arguments)
+    if (HENIFIG_GEN_NAMESPACE)
+        list(APPEND arguments --namespace ${HENIFIG_GEN_NAMESPACE})
+    endif()
+    if (HENIFIG_GEN_STRUCT)
+        list(APPEND arguments --struct ${HENIFIG_GEN_STRUCT})
+    endif()
+
+    file(MAKE_DIRECTORY ${output_dir})
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND ${generator} ${sample} ${output} ${arguments}
+        DEPENDS ${sample} ${generator_dependency}
+        COMMENT "Generating ${HENIFIG_GEN_OUTPUT} from ${sample_name}"
+        VERBATIM
+    )
+    target_sources(${target} PRIVATE ${output})
+    target_include_directories(${target} PRIVATE ${output_dir})
+endfunction()
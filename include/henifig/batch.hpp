@@ -0,0 +1,62 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "henifig/types.hpp"
+
+namespace henifig {
+	struct batch_options {
+		/**
+		 * @brief How many threads to parse on, 0 for one per hardware thread.
+		 */
+		size_t threads{};
+		/**
+		 * @brief Leave the documents which haven't been started yet once one fails. They're reported as LOAD_CANCELLED.
+		 */
+		bool stop_on_error{};
+		/**
+		 * @brief The limits every document gets on its own.
+		 */
+		parse_options parsing;
+	};
+
+	/**
+	 * @brief What became of a single document of a batch. The config is only there if it was loaded successfully.
+	 */
+	struct batch_item {
+		std::unique_ptr <config_t> cfg;
+		parse_report report;
+	};
+
+	/**
+	 * @brief Open many config files at once, spread over a pool of threads which take work from each other
+	 * whenever they run out of their own, so a few big files don't hold the rest back.
+	 * @return The outcome of every file, in the order of the paths.
+	 */
+	std::vector <batch_item> load_files(const std::vector <std::string>& paths, const batch_options& options = {});
+	/**
+	 * @brief Parse many configs at once like @ref load_files does.
+	 * @return The outcome of every buffer, in the order of the buffers.
+	 */
+	std::vector <batch_item> load_buffers(const std::vector <std::string_view>& buffers, const batch_options& options = {});
+}
@@ -0,0 +1,357 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "henifig/types.hpp"
+
+/**
+ * @brief Declare the fields of a struct for @ref henifig::bind.
+ * Must be used in the namespace of the struct, e.g.
+ * HENIFIG_FIELDS(server, henifig::field("host", &server::host), henifig::field("port", &server::port, 8080))
+ */
+#define HENIFIG_FIELDS(type, ...) \
+	[[maybe_unused]] inline auto henifig_fields(const type*) { \
+		return std::make_tuple(__VA_ARGS__); \
+	}
+
+/**
+ * @brief Declare the string names of an enum for @ref henifig::bind.
+ * Must be used in the namespace of the enum, e.g.
+ * HENIFIG_ENUM(mode, {"fast", mode::fast}, {"safe", mode::safe})
+ */
+#define HENIFIG_ENUM(type, ...) \
+	[[maybe_unused]] inline const auto& henifig_enum_values(const type*) { \
+		static const std::pair <std::string_view, type> values[] = {__VA_ARGS__}; \
+		return values; \
+	}
+
+namespace henifig {
+	/**
+	 * @brief A single mismatch found while binding a value to a user type.
+	 */
+	struct bind_error {
+		std::string path;
+		std::string details;
+	};
+
+	using bind_errors = std::vector <bind_error>;
+
+	class bind_exception final : public std::exception {
+		std::string full_error;
+		bind_errors errors;
+	public:
+		bind_exception() = delete;
+		explicit bind_exception(bind_errors errors);
+		[[nodiscard]] const bind_errors& get_errors() const noexcept;
+		[[nodiscard]] const char* what() const noexcept override;
+	};
+
+	/**
+	 * @brief A key bound to a member of S, optionally with a value to use when the key is missing.
+	 */
+	template <typename S, typename M>
+	struct field_t {
+		std::string_view key;
+		M S::* member;
+		std::optional <M> default_value;
+	};
+
+	template <typename S, typename M>
+	field_t <S, M> field(const std::string_view key, M S::* member) {
+		return {key, member, std::nullopt};
+	}
+
+	template <typename S, typename M, typename D>
+	field_t <S, M> field(const std::string_view key, M S::* member, D&& default_value) {
+		return {key, member, M(std::forward <D>(default_value))};
+	}
+
+	namespace detail {
+		template <typename T, typename = void>
+		struct has_fields : std::false_type {};
+
+		template <typename T>
+		struct has_fields <T, std::void_t <decltype(henifig_fields(static_cast <const T*>(nullptr)))>> : std::true_type {};
+
+		template <typename T, typename = void>
+		struct has_enum_values : std::false_type {};
+
+		template <typename T>
+		struct has_enum_values <T, std::void_t <decltype(henifig_enum_values(static_cast <const T*>(nullptr)))>> : std::true_type {};
+
+		template <typename T>
+		constexpr inline bool is_optional = is_specialisation <T, std::optional>::value;
+
+		const char* type_name(const std::size_t& index);
+
+		void mismatch(bind_errors& errors, const std::string& path, const char* expected, const value_t& value);
+
+		template <typename S>
+		void bind_struct(const value_map& map, S& out, const std::string& path, bind_errors& errors);
+
+		template <typename T>
+		void bind_value(const value_t& value, T& out, const std::string& path, bind_errors& errors) {
+			if constexpr (is_optional <T>) {
+				if (value.isdef()) {
+					out.reset();
+					return;
+				}
+				bind_value(value, out.emplace(), path, errors);
+			}
+			else if constexpr (std::is_same_v <T, bool>) {
+				if (value.index() != boolean) {
+					return mismatch(errors, path, type_name(boolean), value);
+				}
+				out = value.get <bool>();
+			}
+			else if constexpr (std::is_same_v <T, char>) {
+				if (value.index() != character) {
+					return mismatch(errors, path, type_name(character), value);
+				}
+				out = value.get <char>();
+			}
+			else if constexpr (std::is_integral_v <T>) {
+				if (value.index() == ulonglong) {
+					const unsigned long long x = value.get <unsigned long long>();
+					if (x > static_cast <unsigned long long>(std::numeric_limits <T>::max())) {
+						errors.push_back({path, "integer out of range"});
+						return;
+					}
+					out = static_cast <T>(x);
+				}
+				else if (value.index() == longlong) {
+					const long long x = value.get <long long>();
+					bool in_range;
+					if constexpr (std::is_unsigned_v <T>) {
+						in_range = x >= 0 && static_cast <unsigned long long>(x) <= std::numeric_limits <T>::max();
+					}
+					else {
+						in_range = x >= std::numeric_limits <T>::min() && x <= std::numeric_limits <T>::max();
+					}
+					if (!in_range) {
+						errors.push_back({path, "integer out of range"});
+						return;
+					}
+					out = static_cast <T>(x);
+				}
+				else {
+					mismatch(errors, path, "integer", value);
+				}
+			}
+			else if constexpr (std::is_floating_point_v <T>) {
+				switch (value.index()) {
+					case floating: {
+						out = static_cast <T>(value.get <double>());
+						break;
+					}
+					case ulonglong: {
+						out = static_cast <T>(value.get <unsigned long long>());
+						break;
+					}
+					case longlong: {
+						out = static_cast <T>(value.get <long long>());
+						break;
+					}
+					default: {
+						mismatch(errors, path, type_name(floating), value);
+					}
+				}
+			}
+			else if constexpr (std::is_same_v <T, std::string>) {
+				if (value.index() != string) {
+					return mismatch(errors, path, type_name(string), value);
+				}
+				out = value.get <std::string>();
+			}
+			else if constexpr (std::is_enum_v <T>) {
+				static_assert(has_enum_values <T>::value, "Enums must be declared with HENIFIG_ENUM to be bound.");
+				if (value.index() != string) {
+					return mismatch(errors, path, type_name(string), value);
+				}
+				const std::string& name = value.get <std::string>();
+				for (const auto& [enum_name, enum_value] : henifig_enum_values(static_cast <const T*>(nullptr))) {
+					if (enum_name == name) {
+						out = enum_value;
+						return;
+					}
+				}
+				errors.push_back({path, "unknown enumerator `" + name + '`'});
+			}
+			else if constexpr (is_vector <T>) {
+				if (value.index() != array) {
+					return mismatch(errors, path, type_name(array), value);
+				}
+				const value_array& arr = value.get <value_array>();
+				out.clear();
+				out.resize(arr.size());
+				for (size_t i = 0; i < arr.size(); i++) {
+					if constexpr (std::is_same_v <typename T::value_type, bool>) {
+						// The items of a std::vector <bool> are proxies, which can't be bound to.
+						bool item = out[i];
+						bind_value(arr[i], item, path + '[' + std::to_string(i) + ']', errors);
+						out[i] = item;
+					}
+					else {
+						bind_value(arr[i], out[i], path + '[' + std::to_string(i) + ']', errors);
+					}
+				}
+			}
+			else if constexpr (is_map <T>) {
+				if (value.index() != map) {
+					return mismatch(errors, path, type_name(map), value);
+				}
+				out.clear();
+				for (const auto& [key, val] : value.get <value_map>()) {
+					bind_value(val, out[key.get()], path + '.' + key.get(), errors);
+				}
+			}
+			else if constexpr (has_fields <T>::value) {
+				if (value.index() != map) {
+					return mismatch(errors, path, type_name(map), value);
+				}
+				bind_struct(value.get <value_map>(), out, path, errors);
+			}
+			else {
+				static_assert(has_fields <T>::value, "Can't bind T: declare its fields with HENIFIG_FIELDS.");
+			}
+		}
+
+		/**
+		 * @brief The fields of S and a key -> field position lookup table, built once per type.
+		 */
+		template <typename S>
+		struct field_table {
+			using fields_type = decltype(henifig_fields(static_cast <const S*>(nullptr)));
+			static constexpr size_t size = std::tuple_size_v <fields_type>;
+			fields_type fields;
+			std::unordered_map <std::string_view, size_t> positions;
+
+			field_table() : fields(henifig_fields(static_cast <const S*>(nullptr))) {
+				fill(std::make_index_sequence <size>{});
+			}
+			template <size_t... Is>
+			void fill(std::index_sequence <Is...>) {
+				(positions.emplace(std::get <Is>(fields).key, Is), ...);
+			}
+			static const field_table& get() {
+				static const field_table table;
+				return table;
+			}
+		};
+
+		template <size_t I, typename S>
+		void bind_field(const field_table <S>& table, const value_t& value, S& out, const std::string& path, bind_errors& errors) {
+			const auto& field = std::get <I>(table.fields);
+			bind_value(value, out.*field.member, path.empty() ? std::string(field.key) : path + '.' + std::string(field.key), errors);
+		}
+
+		template <size_t I, typename S>
+		void finish_field(const field_table <S>& table, const bool& seen, S& out, const std::string& path, bind_errors& errors) {
+			const auto& field = std::get <I>(table.fields);
+			if (seen) {
+				return;
+			}
+			if (field.default_value) {
+				out.*field.member = *field.default_value;
+			}
+			else if constexpr (!is_optional <std::remove_reference_t <decltype(out.*field.member)>>) {
+				errors.push_back({path.empty() ? std::string(field.key) : path + '.' + std::string(field.key), "missing key"});
+			}
+		}
+
+		template <typename S, size_t... Is>
+		void dispatch(const field_table <S>& table, const size_t& position, const value_t& value, S& out, const std::string& path, bind_errors& errors, std::index_sequence <Is...>) {
+			((position == Is && (bind_field <Is>(table, value, out, path, errors), true)) || ...);
+		}
+
+		template <typename S, size_t... Is>
+		void finish(const field_table <S>& table, const std::array <bool, field_table <S>::size>& seen, S& out, const std::string& path, bind_errors& errors, std::index_sequence <Is...>) {
+			(finish_field <Is>(table, seen[Is], out, path, errors), ...);
+		}
+
+		template <typename S>
+		void bind_struct(const value_map& map, S& out, const std::string& path, bind_errors& errors) {
+			const field_table <S>& table = field_table <S>::get();
+			std::array <bool, field_table <S>::size> seen{};
+			for (const auto& [key, value] : map) {
+				const auto found = table.positions.find(key.view());
+				if (found == table.positions.end()) {
+					continue;
+				}
+				seen[found->second] = true;
+				dispatch(table, found->second, value, out, path, errors, std::make_index_sequence <field_table <S>::size>{});
+			}
+			finish(table, seen, out, path, errors, std::make_index_sequence <field_table <S>::size>{});
+		}
+	}
+
+	/**
+	 * @brief Fill a user type from a value, collecting every mismatch instead of stopping at the first one.
+	 * @return All the mismatches found, empty on success.
+	 */
+	template <typename T>
+	bind_errors bind(const value_t& value, T& out) {
+		bind_errors errors;
+		detail::bind_value(value, out, "", errors);
+		return errors;
+	}
+
+	/**
+	 * @brief Fill a struct declared with HENIFIG_FIELDS from the variables of a config.
+	 * @return All the mismatches found, empty on success.
+	 */
+	template <typename S>
+	bind_errors bind(const config_t& cfg, S& out) {
+		bind_errors errors;
+		const detail::field_table <S>& table = detail::field_table <S>::get();
+		std::array <bool, detail::field_table <S>::size> seen{};
+		const std::vector <std::string>& vars = cfg.get_vars();
+		for (size_t i = 0; i < vars.size(); i++) {
+			const auto found = table.positions.find(vars[i]);
+			if (found == table.positions.end()) {
+				continue;
+			}
+			seen[found->second] = true;
+			detail::dispatch(table, found->second, cfg.get_value(i), out, "", errors, std::make_index_sequence <detail::field_table <S>::size>{});
+		}
+		detail::finish(table, seen, out, "", errors, std::make_index_sequence <detail::field_table <S>::size>{});
+		return errors;
+	}
+
+	/**
+	 * @brief Build a struct declared with HENIFIG_FIELDS from the variables of a config.
+	 * @exception bind_exception Holding every mismatch if there was at least one.
+	 */
+	template <typename S>
+	S bind(const config_t& cfg) {
+		S res{};
+		if (bind_errors errors = bind(cfg, res); !errors.empty()) {
+			throw bind_exception(std::move(errors));
+		}
+		return res;
+	}
+}
@@ -59,6 +59,18 @@ namespace henifig {
 		REDECLARED_KEY,
 		FILE_OPEN_FAILED,
 		UNEXPECTED_ESCAPE,
+		INCLUDE_CYCLE,
+		LOAD_CANCELLED,
+		INPUT_TOO_LARGE,
+		TOO_DEEP,
+		TOO_MANY_NODES,
+		LITERAL_TOO_LONG,
+		CONTAINER_TOO_BIG,
+		TOO_MANY_VARS,
+		PARSE_CANCELLED,
+		DEADLINE_EXCEEDED,
+		TYPE_MISMATCH,
+		INCLUDE_NOT_ALLOWED,
 	};
 
 	inline const char* error_messages[] = {
@@ -103,6 +115,18 @@ namespace henifig {
 		"redeclared variable",
 		"redeclared map value key",
 		"failed to open the file",
-		"unexpected escape sequence"
+		"unexpected escape sequence",
+		"circular include",
+		"not loaded after an earlier document failed",
+		"input bigger than allowed",
+		"containers nested deeper than allowed",
+		"more values than allowed",
+		"literal longer than allowed",
+		"more items in a container than allowed",
+		"more variables than allowed",
+		"parsing cancelled",
+		"parsing took longer than allowed",
+		"value of another type than the generated struct expects",
+		"@include isn't allowed by the parse options"
 	};
 }
@@ -21,9 +21,11 @@
 namespace henifig {
 	class parse_exception final : public std::exception {
 		std::string full_error;
+		parse_report report;
 	public:
 		parse_exception() = delete;
 		explicit parse_exception(const parse_report& report);
+		[[nodiscard]] const parse_report& get_report() const noexcept;
 		[[nodiscard]] const char* what() const noexcept override;
 	};
 	class retrieval_exception final : public std::exception {
@@ -0,0 +1,37 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#pragma once
+
+#include <string>
+
+#include "henifig/sax.hpp"
+
+namespace henifig {
+	/**
+	 * @brief What the loaders made by henifig-gen write their fields with.
+	 * Each returns false if the value can't go in the field; a declaration leaves the field as it is.
+	 * Integers go into doubles and into the other integer type when they fit.
+	 */
+	namespace generated {
+		bool assign(const scalar_t& x, std::string& out);
+		bool assign(const scalar_t& x, char& out);
+		bool assign(const scalar_t& x, double& out);
+		bool assign(const scalar_t& x, unsigned long long& out);
+		bool assign(const scalar_t& x, long long& out);
+		bool assign(const scalar_t& x, bool& out);
+	}
+}
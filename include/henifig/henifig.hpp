@@ -23,6 +23,15 @@
 #include "henifig/types.hpp"
 #include "henifig/exception.hpp"
 #include "henifig/parser.hpp"
+#include "henifig/bind.hpp"
+#include "henifig/sax.hpp"
+#include "henifig/reader.hpp"
+#include "henifig/overlay.hpp"
+#include "henifig/snapshot.hpp"
+#include "henifig/batch.hpp"
+#include "henifig/static_config.hpp"
+#include "henifig/schema.hpp"
+#include "henifig/shared.hpp"
 
 namespace henifig {
 	class process_logger {
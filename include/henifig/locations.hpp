@@ -0,0 +1,95 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace henifig {
+	/**
+	 * @brief Where something was written in a config, 1-based. Both are 0 if it isn't known.
+	 */
+	struct source_location {
+		size_t line{};
+		size_t index{};
+		[[nodiscard]] bool is_known() const;
+	};
+
+	/**
+	 * @brief Where the items of every container of a config were written, kept apart from the values themselves.
+	 * The positions of each container are stored together, each one as the difference from the one before it,
+	 * which takes a couple of bytes in the usual case. Every @ref checkpoint_interval positions, the full position
+	 * is kept aside as well, so getting one only decodes the few after the closest checkpoint.
+	 */
+	class location_table {
+		struct entry {
+			uint32_t container;
+			size_t line, index;
+		};
+		struct checkpoint {
+			// Where the positions after the checkpoint begin in bytes.
+			uint32_t offset;
+			size_t line, index;
+		};
+		std::vector <checkpoint> checkpoints;
+		// Where the checkpoints of each container begin, with the end of the last one at the back.
+		std::vector <uint32_t> checkpoint_starts;
+		// What the parser recorded, until it's all encoded by finish().
+		std::vector <entry> recorded;
+		std::vector <uint8_t> bytes;
+		// Where the positions of each container begin in bytes, with the end of the last one at the back.
+		std::vector <uint32_t> starts;
+		// The containers sorted by address, to find their positions from their values.
+		std::vector <std::pair <const void*, uint32_t>> containers;
+	public:
+		/**
+		 * @brief The number of the top level, which holds the name and the value of every variable.
+		 */
+		static constexpr uint32_t top = 0;
+		static constexpr size_t checkpoint_interval = 64;
+
+		/**
+		 * @brief Give a number to a container. Arrays hold the position of every item, maps that of every key and its value.
+		 */
+		uint32_t add_container(const void* address);
+		void record(const uint32_t& container, const size_t& line, const size_t& index);
+		/**
+		 * @brief Encode everything recorded, after which nothing can be added.
+		 */
+		void finish();
+		void clear();
+		[[nodiscard]] bool empty() const;
+		/**
+		 * @return The number of the container at the given address, top if it isn't known.
+		 */
+		[[nodiscard]] uint32_t find(const void* address) const;
+		/**
+		 * @brief Follow the containers to their new addresses, given as old and new address pairs sorted by the old one.
+		 */
+		void rebase(const std::vector <std::pair <const void*, const void*>>& moved);
+		/**
+		 * @brief Get the position recorded at the given place in a container.
+		 */
+		[[nodiscard]] source_location get(const uint32_t& container, const size_t& position) const;
+		/**
+		 * @brief The amount of bytes the encoded positions and their checkpoints take.
+		 */
+		[[nodiscard]] size_t size_in_bytes() const;
+	};
+}
@@ -0,0 +1,78 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <optional>
+
+namespace henifig {
+	/**
+	 * @brief Limits for parsing configs which can't be trusted. Going past one stops the parsing with its own error,
+	 * before anything more than allowed gets allocated. A config and the files it includes share one budget.
+	 */
+	struct parse_options {
+		static constexpr size_t unlimited = std::numeric_limits <size_t>::max();
+		size_t max_input_bytes{unlimited};
+		/**
+		 * @brief How many containers can be inside each other, a variable holding an array being at depth 1.
+		 */
+		size_t max_depth{unlimited};
+		/**
+		 * @brief How many values there can be in total, counting the containers and the values of variables.
+		 */
+		size_t max_nodes{unlimited};
+		/**
+		 * @brief The longest a string, name, key, number or include path can be, in bytes as written.
+		 */
+		size_t max_string_length{unlimited};
+		/**
+		 * @brief How many items an array or entries a map can have.
+		 */
+		size_t max_container_size{unlimited};
+		size_t max_vars{unlimited};
+		/**
+		 * @brief Set to true from anywhere to stop the parsing, which checks it every few kilobytes.
+		 */
+		const std::atomic <bool>* cancel{};
+		/**
+		 * @brief When to give up on the parsing, checked as often as the cancellation.
+		 */
+		std::chrono::steady_clock::time_point deadline{std::chrono::steady_clock::time_point::max()};
+		/**
+		 * @brief Whether @include directives are followed. Unless set, they only are when nothing is limited,
+		 * since a config which can't be trusted could otherwise have any file it names read.
+		 */
+		std::optional <bool> allow_includes;
+
+		/**
+		 * @brief Whether any of the limits, the cancellation or the deadline is set.
+		 */
+		[[nodiscard]] bool is_limited() const;
+		[[nodiscard]] bool includes_allowed() const;
+	};
+
+	/**
+	 * @brief What a config and the files it includes used up of the limits together.
+	 */
+	struct parse_usage {
+		std::atomic <size_t> bytes{}, nodes{}, vars{};
+	};
+}
@@ -0,0 +1,86 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <functional>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+
+#include "henifig/parser.hpp"
+
+namespace henifig {
+	/**
+	 * @brief A value looked up through the layers of an overlay.
+	 * Maps are merged key by key, any other value shadows whatever the layers below have at the same path.
+	 */
+	class overlay_node {
+		// The values found at this path, from the highest precedence to the lowest.
+		std::vector <const value_t*> layers;
+		void push(const value_t& x);
+		friend class overlay_t;
+	public:
+		[[nodiscard]] bool exists() const;
+		/**
+		 * @brief The value of the layer with the highest precedence, without merging anything.
+		 * @exception retrieval_exception If no layer has a value here.
+		 */
+		[[nodiscard]] const value_t& value() const;
+		[[nodiscard]] size_t index() const;
+		template <typename T>
+		[[nodiscard]] decltype(auto) get() const {
+			return value().get <T>();
+		}
+		[[nodiscard]] bool contains(std::string_view key) const;
+		[[nodiscard]] overlay_node operator [](std::string_view key) const;
+		/**
+		 * @brief The keys of the merged map, in the order the layers first declare them, lowest precedence first.
+		 */
+		[[nodiscard]] std::vector <istring> keys() const;
+	};
+
+	/**
+	 * @brief A read-only view of several configs stacked on top of each other. Nothing is copied,
+	 * the layers must outlive the overlay.
+	 */
+	class overlay_t {
+		std::vector <const config_t*> layers;
+		static value_t flatten_node(config_t& res, const overlay_node& node);
+	public:
+		overlay_t() = default;
+		/**
+		 * @param layers From the lowest precedence to the highest.
+		 */
+		overlay_t(std::initializer_list <std::reference_wrapper <const config_t>> layers);
+		/**
+		 * @brief Add a layer taking precedence over every previous one.
+		 */
+		overlay_t& push(const config_t& layer);
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool contains(std::string_view var) const;
+		[[nodiscard]] overlay_node operator [](std::string_view var) const;
+		/**
+		 * @brief Every variable, in the order the layers first declare them, lowest precedence first.
+		 */
+		[[nodiscard]] std::vector <std::string> get_vars() const;
+		/**
+		 * @brief Merge the layers into a config of its own in one pass, which doesn't need the layers anymore.
+		 */
+		[[nodiscard]] config_t flatten() const;
+	};
+}
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
 #include <string>
 #include <sstream>
 #include <stack>
@@ -24,3 +25,54 @@
 
 #include "henifig/types.hpp"
 #include "henifig/exception.hpp"
+
+namespace henifig {
+	/**
+	 * @brief Parses one config after another, keeping the memory of the previous ones warm for the next.
+	 * Once it has seen configs of about the same shape and strings, parsing allocates nothing.
+	 * The strings of every config parsed are kept in one pool, which lives as long as the parser
+	 * or any config parsed into it, and grows with every new string unless @ref set_pool_limit is used.
+	 */
+	class parser {
+		std::shared_ptr <string_pool> pool;
+		std::shared_ptr <config_t::stream_t> stream;
+		std::vector <std::unique_ptr <config_t>> free_configs;
+		size_t pool_limit{};
+	public:
+		/**
+		 * @brief Gives a config back to the parser it came from once it's no longer needed.
+		 */
+		class recycler {
+			parser* owner{};
+		public:
+			recycler() = default;
+			explicit recycler(parser& owner) : owner(&owner) {}
+			void operator ()(config_t* cfg) const;
+		};
+		using config_ptr = std::unique_ptr <config_t, recycler>;
+
+		/**
+		 * @param pool Where the strings of every parsed config are interned, so the repeated ones are only stored once.
+		 */
+		explicit parser(std::shared_ptr <string_pool> pool = std::make_shared <string_pool>());
+		parser(const parser&) = delete;
+		parser& operator =(const parser&) = delete;
+		/**
+		 * @brief Replace the contents of a config with the parsed ones, reusing the memory it held.
+		 * @exception parse_exception If the content isn't a valid config, which leaves the config cleared.
+		 */
+		void parse(std::string_view content, config_t& out);
+		/**
+		 * @brief Parse into a config taken from the ones given back to this parser.
+		 * The parser must outlive the configs it hands out.
+		 * @exception parse_exception If the content isn't a valid config.
+		 */
+		[[nodiscard]] config_ptr parse(std::string_view content);
+		[[nodiscard]] const std::shared_ptr <string_pool>& get_string_pool() const;
+		/**
+		 * @brief Start a new string pool before a parse once the current one holds more than the given amount of characters.
+		 * The old pool is freed when the last config still using it is cleared, destroyed or parsed into again. 0 means no limit.
+		 */
+		void set_pool_limit(const size_t& bytes);
+	};
+}
@@ -0,0 +1,130 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+
+#include "henifig/sax.hpp"
+#include "henifig/exception.hpp"
+
+namespace henifig {
+	/**
+	 * @brief Walks a config one token at a time, leaving it to the caller to decide what's worth reading.
+	 * Strings are views into the buffer wherever they were written without escapes, which must outlive the reader.
+	 * Other strings only live until the next token.
+	 * Only the containers it's in are kept, so the memory doesn't grow with the size of the buffer.
+	 */
+	class reader {
+	public:
+		enum class token : uint8_t {
+			none,
+			var,
+			key,
+			scalar,
+			array_begin,
+			array_end,
+			map_begin,
+			map_end,
+			end,
+		};
+	private:
+		struct entry {
+			token type{token::none};
+			std::string_view name;
+			scalar_t value;
+			// Set when the text had to be unescaped and can't be looked at in the buffer.
+			std::string owned;
+			bool is_owned{};
+			size_t depth{}, offset{};
+			size_t line{}, index{};
+
+			// Points the views back at owned after the entry has been moved.
+			void fix();
+		};
+		class collector final : public sax_handler {
+			reader& owner;
+		public:
+			explicit collector(reader& owner) : owner(owner) {}
+			error_codes on_var(std::string_view name) override;
+			error_codes on_key(std::string_view key) override;
+			error_codes on_scalar(const scalar_t& x) override;
+			error_codes on_array_begin() override;
+			error_codes on_array_end() override;
+			error_codes on_map_begin() override;
+			error_codes on_map_end() override;
+		};
+		std::string_view content;
+		collector events;
+		sax_parser parser;
+		// A single character can end one thing and begin another.
+		std::deque <entry> queue;
+		entry current;
+		size_t resume{};
+		bool finished{};
+		error_codes skip_error{OK};
+		size_t skip_line{}, skip_index{};
+
+		entry& push(token type);
+		void keep(entry& x, std::string_view& view) const;
+	public:
+		explicit reader(std::string_view content, std::string_view filename = "");
+		reader(const reader&) = delete;
+		reader& operator =(const reader&) = delete;
+		/**
+		 * @brief Move to the next token.
+		 * @return false once the end of the buffer or an error has been reached.
+		 */
+		bool next();
+		/**
+		 * @brief Move to the next variable, skipping whatever's left of the current one.
+		 * @return false if there are no variables left.
+		 */
+		bool next_var();
+		[[nodiscard]] token type() const;
+		/**
+		 * @brief The name of the current variable or key.
+		 */
+		[[nodiscard]] std::string_view name() const;
+		[[nodiscard]] const scalar_t& scalar() const;
+		/**
+		 * @brief The current scalar as T, which must be one of the alternatives of scalar_t.
+		 * @exception retrieval_exception If the scalar is of another type.
+		 */
+		template <typename T>
+		[[nodiscard]] T get() const {
+			if (const T* res = std::get_if <T>(&current.value)) {
+				return *res;
+			}
+			throw retrieval_exception("The current token isn't a scalar of the requested type.");
+		}
+		/**
+		 * @brief How many containers the current token is in. A container's own begin and end tokens are outside of it.
+		 */
+		[[nodiscard]] size_t depth() const;
+		[[nodiscard]] size_t get_line() const;
+		[[nodiscard]] size_t get_index() const;
+		/**
+		 * @brief Jump past the array or map which was just begun by matching brackets, without parsing its contents.
+		 * The next token is whatever comes after its end. Does nothing on any other token.
+		 */
+		void skip();
+		[[nodiscard]] parse_report get_report() const;
+	};
+}
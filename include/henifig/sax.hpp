@@ -0,0 +1,229 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "henifig/options.hpp"
+#include "henifig/types.hpp"
+
+namespace henifig {
+	/**
+	 * @brief A value which isn't a container. Its alternatives are in the order of data_types, like value_variant's.
+	 * Strings are views which only live for the duration of the event.
+	 */
+	using scalar_t = std::variant <unset_t, declaration_t, std::string_view, char, double, unsigned long long, long long, bool>;
+
+	/**
+	 * @brief Receives the events of a @ref sax_parser. Every event returns OK to carry on, anything else
+	 * stops the parsing and gets reported at the current position.
+	 */
+	class sax_handler {
+	public:
+		virtual ~sax_handler() = default;
+		virtual error_codes on_var(std::string_view name);
+		virtual error_codes on_key(std::string_view key);
+		/**
+		 * @brief A value of a variable, an array item or a map key. A declaration if nothing was piped in.
+		 */
+		virtual error_codes on_scalar(const scalar_t& x);
+		virtual error_codes on_array_begin();
+		virtual error_codes on_array_end();
+		virtual error_codes on_map_begin();
+		virtual error_codes on_map_end();
+		/**
+		 * @brief An @include directive, the path being given as written. Ignored unless overridden.
+		 */
+		virtual error_codes on_include(std::string_view path);
+	};
+
+	/**
+	 * @brief Reads a config and hands its contents to a @ref sax_handler as they're read, without building anything.
+	 * It only keeps the containers it's in and the literal it's reading, no matter the size of the input.
+	 * Every character is looked at a bounded number of times and nothing recurses, so the time taken is linear
+	 * in the size of the input however it's laid out.
+	 * The input can be given at once with @ref parse or in pieces with @ref feed and @ref finish.
+	 */
+	class sax_parser {
+		enum class state : uint8_t {
+			top,
+			name,
+			name_escape,
+			after_name,
+			directive,
+			directive_path,
+			path,
+			directive_end,
+			value,
+			string,
+			string_escape,
+			string_end,
+			character,
+			character_escape,
+			character_end,
+			number,
+			keyword,
+			after_value,
+			array_first,
+			array_next,
+			map_first,
+			map_next,
+			dollar,
+			key,
+			key_escape,
+			after_key,
+			var_end,
+			// Skipping what's left of a broken declaration.
+			recover,
+		};
+		enum class comment_state : uint8_t {
+			none,
+			line,
+			block,
+			block_hash,
+		};
+		struct frame {
+			data_types type{};
+			size_t line{}, index{};
+			// Where the items begin within the chunk.
+			size_t offset{};
+			size_t items{};
+		};
+		sax_handler* handler;
+		std::string filename;
+		state current{state::top};
+		comment_state comment{comment_state::none};
+		// A '[' or '#' which could begin a comment, held until the next character tells.
+		char pending{};
+		size_t pending_line{}, pending_index{};
+		std::vector <frame> frames;
+		// The literal being read. Strings without escapes are viewed straight from the input instead.
+		std::string token;
+		const char* chunk{};
+		size_t view_begin{NPOS}, view_end{NPOS};
+		size_t pos{};
+		size_t line{1}, index{};
+		size_t literal_line{}, literal_index{};
+		size_t comment_line{}, comment_index{};
+		bool newline_in_literal{};
+		bool is_float{};
+		// Where the items of the container being opened begin.
+		size_t opening{};
+		// Set by a handler to return from run() once the current character is done with.
+		bool paused{};
+		error_codes error{OK};
+		size_t error_line{}, error_index{};
+		static constexpr size_t max_details = 256;
+		std::string error_details;
+		bool recovering{};
+		// Whether everything since the beginning of the line was blank, for declarations to be found after an error.
+		bool line_blank{true};
+		// Whether the current document got any input yet, the errors of the previous one are kept until then.
+		bool started{};
+		std::vector <parse_report> errors;
+		parse_options options;
+		// How many bytes go by between two looks at the cancellation, the deadline and the literal being read.
+		static constexpr size_t block_size = 4096;
+		// What the current document used up of the limits.
+		size_t bytes_read{}, nodes{}, vars{};
+		// What it used up together with the documents it shares its limits with, if there are any.
+		parse_usage* usage{};
+
+		[[nodiscard]] bool raw() const;
+		void put(char c);
+		void step(char c);
+		void start_value(char c);
+		void open(data_types type, size_t offset, size_t open_line, size_t open_index);
+		void close(data_types type);
+		void end_number();
+		void end_string();
+		void flush_view(size_t end);
+		[[nodiscard]] std::string_view literal() const;
+		void check(error_codes code, std::string_view details = "");
+		void fail(error_codes code, std::string_view details = "");
+		void fail_at(error_codes code, size_t error_line, size_t error_index, std::string_view details = "");
+		void recover(char c);
+		bool within(size_t count, size_t limit, error_codes code);
+		/**
+		 * @brief Add to the amount of something the document used up.
+		 * @return The amount to check against the limit, shared with other documents if there's a usage.
+		 */
+		size_t charge(size_t& own, std::atomic <size_t> parse_usage::* shared, size_t amount);
+		bool add_node();
+		error_codes scalar(const scalar_t& x);
+		error_codes var(std::string_view name);
+		void check_time();
+		[[nodiscard]] static bool is_limit(error_codes code);
+		void reset();
+		size_t run(std::string_view content, size_t from);
+		void end_input();
+		[[nodiscard]] parse_report report() const;
+		friend class reader;
+	public:
+		explicit sax_parser(sax_handler& handler, std::string_view filename = "");
+		/**
+		 * @brief Read a whole config, firing the events of the handler along the way.
+		 * @return The first error found, either in the text or returned by the handler.
+		 */
+		parse_report parse(std::string_view content);
+		/**
+		 * @brief Read the next piece of a config which arrives bit by bit. A piece may end anywhere,
+		 * even in the middle of a string, an escape or a comment; only the literal being read is kept from it.
+		 * @return false once an error was found, which @ref finish reports.
+		 */
+		bool feed(std::string_view chunk);
+		/**
+		 * @brief End the config given to @ref feed and get ready for the next one.
+		 * @return The first error found, including whatever was left hanging at the end.
+		 */
+		parse_report finish();
+		/**
+		 * @brief Carry on after an error instead of stopping, from the next line beginning with a declaration.
+		 * Whatever containers were left open get their end events, the handler's events stay balanced.
+		 */
+		void set_recovery(const bool& enabled);
+		/**
+		 * @brief Every error found in the last config when recovering, in the order they were found.
+		 * Kept until the next config is given.
+		 */
+		[[nodiscard]] const std::vector <parse_report>& get_errors() const;
+		/**
+		 * @brief Limit what the next configs can use up. Going past a limit ends the config even when recovering.
+		 */
+		void set_options(const parse_options& new_options);
+		[[nodiscard]] const parse_options& get_options() const;
+		/**
+		 * @brief Charge what the next configs use up to a usage shared with other parsers, e.g. of the files they include,
+		 * rather than each config on its own. nullptr to go back to the latter. The usage must outlive the parsing.
+		 */
+		void set_usage(parse_usage* shared);
+		/**
+		 * @brief The position of the character being read, for the handler to know where an event comes from.
+		 */
+		[[nodiscard]] size_t get_line() const;
+		[[nodiscard]] size_t get_index() const;
+		/**
+		 * @brief Where the subject of the current event begins: the name, key or literal, or the opening bracket.
+		 */
+		[[nodiscard]] size_t get_token_line() const;
+		[[nodiscard]] size_t get_token_index() const;
+	};
+}
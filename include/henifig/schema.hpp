@@ -0,0 +1,181 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "henifig/types.hpp"
+
+namespace henifig {
+	/**
+	 * @brief A value that doesn't match its schema, the path being written like @ref bind_error's.
+	 */
+	struct schema_violation {
+		std::string path;
+		std::string details;
+	};
+
+	using schema_violations = std::vector <schema_violation>;
+
+	class compiled_schema;
+
+	/**
+	 * @brief Memory for checking maps of more than 64 keys, to reuse between validations for them not to allocate.
+	 */
+	class validation_scratch {
+		// Which keys of the maps being checked were found, a bit each.
+		std::vector <uint64_t> seen;
+		friend class compiled_schema;
+	};
+
+	/**
+	 * @brief What a value is expected to look like, e.g.
+	 * schema::map().required("port", schema::integer().range(1, 65535)).optional("mode", schema::string().one_of({"fast", "safe"}))
+	 * Describing it is cheap but checking takes compiling it with @ref compile first.
+	 */
+	class schema {
+		struct key_t {
+			std::string name;
+			std::shared_ptr <const schema> value;
+			bool required{};
+		};
+		// Unset for anything.
+		data_types type{unset};
+		bool integral{}, numeric{};
+		std::optional <double> min, max;
+		size_t min_length{}, max_length{NPOS};
+		std::vector <std::string> choices;
+		std::shared_ptr <const schema> items;
+		std::vector <key_t> keys;
+		bool closed_map{};
+		friend class compiled_schema;
+		explicit schema(data_types type);
+		schema& key(std::string_view name, const schema& value, bool required);
+	public:
+		/**
+		 * @brief Any value, declarations included.
+		 */
+		static schema any();
+		static schema string();
+		static schema character();
+		static schema boolean();
+		/**
+		 * @brief A signed or an unsigned integer.
+		 */
+		static schema integer();
+		/**
+		 * @brief An integer or a double.
+		 */
+		static schema number();
+		static schema array(const schema& items);
+		static schema map();
+		/**
+		 * @brief Bound a number, both ends included. The value is compared as a double.
+		 */
+		schema& range(double min, double max);
+		/**
+		 * @brief Only allow the given strings.
+		 */
+		schema& one_of(std::vector <std::string> choices);
+		/**
+		 * @brief Bound the amount of items of an array or the size of a string, both ends included.
+		 */
+		schema& length(size_t min, size_t max = NPOS);
+		schema& required(std::string_view name, const schema& value);
+		schema& optional(std::string_view name, const schema& value);
+		/**
+		 * @brief Report the keys of a map which the schema doesn't have, they're let through otherwise.
+		 */
+		schema& closed();
+		[[nodiscard]] compiled_schema compile() const;
+	};
+
+	/**
+	 * @brief A schema flattened into a table of rules, each map's keys being next to each other.
+	 * A value is checked in a single walk which doesn't allocate unless it finds a violation,
+	 * or checks a map of more than 64 keys without a @ref validation_scratch grown big enough by earlier validations;
+	 * the rules are shared by the copies and can be used from several threads at once.
+	 */
+	class compiled_schema {
+		struct rule {
+			data_types type{unset};
+			bool integral{}, numeric{}, closed{};
+			bool has_min{}, has_max{};
+			double min{}, max{};
+			size_t min_length{}, max_length{NPOS};
+			uint32_t items{};
+			uint32_t first_key{}, key_count{}, required_count{};
+			uint32_t first_choice{}, choice_count{};
+			// Where the key index of a map is, NPOS for a map small enough to be looked through.
+			size_t index{NPOS};
+		};
+		struct key_rule {
+			std::string name;
+			uint32_t rule{};
+			bool required{};
+		};
+		struct program {
+			std::vector <rule> rules;
+			std::vector <key_rule> keys;
+			std::vector <std::string> choices;
+			std::vector <std::unordered_map <std::string_view, uint32_t>> indexes;
+		};
+		// A step of the path to the value being checked, only written out for a violation.
+		struct step {
+			const step* parent{};
+			std::string_view key;
+			size_t index{NPOS};
+		};
+		static constexpr uint32_t index_threshold = 8;
+		std::shared_ptr <const program> code;
+		static uint32_t add(program& code, const schema& s);
+		static std::string path_of(const step* path);
+		void check(const rule& r, const value_t& value, const step* path, schema_violations& out, validation_scratch& scratch) const;
+		void check_scalar(const rule& r, const value_t& value, const step* path, schema_violations& out) const;
+		void check_range(const rule& r, double x, const step* path, schema_violations& out) const;
+		void check_array(const rule& r, const array_t& arr, const step* path, schema_violations& out, validation_scratch& scratch) const;
+		template <typename At>
+		void check_map(const rule& r, size_t count, const At& at, const step* path, schema_violations& out, validation_scratch& scratch) const;
+		[[nodiscard]] const key_rule* find_key(const rule& r, std::string_view name) const;
+	public:
+		explicit compiled_schema(const schema& root);
+		/**
+		 * @brief Check a value, adding every violation found to out.
+		 * @return Whether the value matched.
+		 */
+		bool validate(const value_t& value, schema_violations& out) const;
+		/**
+		 * @brief Check the variables of a config as the keys of a map.
+		 * @return Whether the config matched.
+		 */
+		bool validate(const config_t& cfg, schema_violations& out) const;
+		/**
+		 * @brief Check a value like @ref validate does, keeping what it needs for big maps in scratch for the next validations.
+		 * A scratch can only be used by one thread at a time.
+		 */
+		bool validate(const value_t& value, schema_violations& out, validation_scratch& scratch) const;
+		bool validate(const config_t& cfg, schema_violations& out, validation_scratch& scratch) const;
+		[[nodiscard]] schema_violations validate(const value_t& value) const;
+		[[nodiscard]] schema_violations validate(const config_t& cfg) const;
+	};
+}
@@ -0,0 +1,177 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "henifig/types.hpp"
+#include "henifig/value_reader.hpp"
+
+namespace henifig {
+	/**
+	 * @brief A value of a published config. Everything it refers to is an offset or a position within the image,
+	 * so the image reads the same wherever it's mapped.
+	 */
+	struct shared_node {
+		uint8_t type{unset};
+		uint8_t reserved[3]{};
+		uint32_t key_size{};
+		// The name of a variable or the key of a map entry, within the characters.
+		uint64_t key_first{};
+		// Strings: where their characters are. Containers: the position of their first item, the items being next to each other.
+		uint64_t first{}, size{};
+		// Characters, booleans and both kinds of integers, or the bits of a double.
+		uint64_t bits{};
+		// Where the items of a big map are listed sorted by key, NPOS for a map small enough to be looked through.
+		uint64_t index{NPOS};
+	};
+
+	/**
+	 * @brief What a published config begins with. The sections are given as offsets from the beginning of the image.
+	 */
+	struct shared_header {
+		char magic[8]{};
+		uint32_t format{};
+		uint32_t node_size{};
+		// Which publication of the config this is, counting from 1.
+		uint64_t generation{};
+		uint64_t size{};
+		uint64_t nodes{}, node_count{};
+		uint64_t index{}, index_count{};
+		uint64_t chars{}, chars_size{};
+	};
+
+	/**
+	 * @brief A read-only view of a value of a @ref shared_config, read like a @ref static_value.
+	 */
+	class shared_value : public detail::value_reader <shared_value> {
+		friend class detail::value_reader <shared_value>;
+
+		const shared_node* nodes{};
+		const uint64_t* sorted{};
+		const char* chars{};
+		uint64_t at{};
+
+		[[nodiscard]] const shared_node& node() const {
+			return nodes[at];
+		}
+		[[nodiscard]] double stored_double() const {
+			double res;
+			std::memcpy(&res, &node().bits, sizeof(res));
+			return res;
+		}
+		[[nodiscard]] unsigned long long stored_integer() const {
+			return node().bits;
+		}
+		[[nodiscard]] uint64_t find_index(std::string_view key) const;
+	public:
+		shared_value(const shared_node* nodes, const uint64_t* sorted, const char* chars, const uint64_t& at);
+
+		/**
+		 * @brief An item of an array or the value of the nth entry of a map, in constant time.
+		 * @exception std::out_of_range If there's no such item.
+		 */
+		[[nodiscard]] shared_value operator [](const size_t& item) const {
+			if ((node().type != array && node().type != map) || item >= node().size) {
+				throw std::out_of_range("shared_value::operator []");
+			}
+			return {nodes, sorted, chars, node().first + item};
+		}
+		/**
+		 * @exception std::out_of_range If this isn't a map or the key isn't in it.
+		 */
+		[[nodiscard]] shared_value operator [](std::string_view key) const;
+		[[nodiscard]] bool contains(const std::string_view key) const {
+			return find_index(key) != NPOS;
+		}
+	};
+
+	/**
+	 * @brief Lay out a config as a self-contained image which can be mapped anywhere, e.g. to publish it by other means.
+	 */
+	std::vector <unsigned char> make_shared_image(const config_t& cfg, const uint64_t& generation = 1);
+
+	/**
+	 * @brief A config published in shared memory, read in place by any number of processes.
+	 * Copies share the mapping, which is released with the last of them.
+	 */
+	class shared_config {
+		std::shared_ptr <const void> mapping;
+		// The segment telling which generation of a named config is the current one, if attached by name.
+		std::shared_ptr <const void> control;
+		const shared_header* header{};
+		const shared_node* nodes{};
+		const uint64_t* sorted{};
+		const char* chars{};
+
+		void check_image(size_t length);
+	public:
+		shared_config() = default;
+		/**
+		 * @brief Read an image in memory, which has to outlive the config and stay aligned to 8 bytes.
+		 * @exception retrieval_exception If it isn't a complete image.
+		 */
+		static shared_config view(const void* data, size_t length);
+		/**
+		 * @brief Map the image held by a file descriptor, e.g. one from @ref publish_memfd handed to a child process.
+		 * @exception std::system_error If it can't be mapped.
+		 */
+		static shared_config attach(int fd);
+		/**
+		 * @brief Map the current generation of a config published under a POSIX shared memory name.
+		 */
+		static shared_config attach(std::string_view name);
+		/**
+		 * @brief Publish a config under a POSIX shared memory name, beginning with a '/'.
+		 * Each publication goes in a segment of its own which readers switch to at once once it's complete;
+		 * the replaced one is unlinked and lives on until its readers let it go.
+		 * @return The generation of the publication.
+		 */
+		static uint64_t publish(const config_t& cfg, std::string_view name);
+		/**
+		 * @brief Remove every segment of a published config. Those mapped stay readable.
+		 */
+		static void unpublish(std::string_view name);
+		/**
+		 * @brief Write a config in an anonymous memory file and seal it, to hand to child processes.
+		 * The descriptor is closed on exec, which fcntl can change; forked children keep it.
+		 * @exception std::system_error If memfd isn't supported.
+		 */
+		static int publish_memfd(const config_t& cfg);
+
+		[[nodiscard]] uint64_t generation() const;
+		/**
+		 * @brief Whether a newer generation got published since this one was attached by name.
+		 */
+		[[nodiscard]] bool outdated() const;
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool contains(std::string_view var) const;
+		/**
+		 * @exception std::out_of_range If there's no such variable.
+		 */
+		[[nodiscard]] shared_value operator [](std::string_view var) const;
+		[[nodiscard]] shared_value get_value(const size_t& index) const;
+	};
+}
@@ -0,0 +1,189 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "henifig/parser.hpp"
+
+namespace henifig {
+	class snapshot_value;
+
+	namespace detail {
+		template <typename K, typename V>
+		struct tree_node;
+
+		/**
+		 * @brief An immutable balanced tree. Edits copy the nodes on the path to the edited one and share the rest.
+		 */
+		template <typename K, typename V>
+		using tree_ptr = std::shared_ptr <const tree_node <K, V>>;
+	}
+
+	/**
+	 * @brief An array of a snapshot, its items ordered by the id they got when they were added.
+	 */
+	struct snapshot_array {
+		detail::tree_ptr <uint64_t, snapshot_value> items;
+		uint64_t next_id{};
+	};
+
+	/**
+	 * @brief A map of a snapshot, kept in insertion order like value_map.
+	 */
+	struct snapshot_map {
+		detail::tree_ptr <std::string, uint64_t> ids;
+		detail::tree_ptr <uint64_t, std::pair <std::string, snapshot_value>> entries;
+		uint64_t next_id{};
+	};
+
+	using snapshot_variant = std::variant
+	<unset_t, declaration_t, std::shared_ptr <const std::string>, char, double, unsigned long long, long long, bool, snapshot_array, snapshot_map>;
+
+	/**
+	 * @brief A value of a snapshot. Its alternatives are in the order of data_types, like value_variant's.
+	 */
+	class snapshot_value {
+	public:
+		snapshot_variant value;
+		snapshot_value() = default;
+		snapshot_value(declaration_t x);
+		snapshot_value(const char* x);
+		snapshot_value(std::string_view x);
+		snapshot_value(const std::string& x);
+		snapshot_value(char x);
+		snapshot_value(double x);
+		snapshot_value(bool x);
+		snapshot_value(snapshot_array x);
+		snapshot_value(snapshot_map x);
+		// Integers are stored like the parser does: negative ones as long long, the rest as unsigned long long.
+		template <typename T, std::enable_if_t <std::is_integral_v <T> && !std::is_same_v <T, bool> && !std::is_same_v <T, char>, int> = 0>
+		snapshot_value(const T x) {
+			if constexpr (std::is_signed_v <T>) {
+				if (x < 0) {
+					value = static_cast <long long>(x);
+					return;
+				}
+			}
+			value = static_cast <unsigned long long>(x);
+		}
+
+		[[nodiscard]] size_t index() const;
+		/**
+		 * @brief Get a reference to the underlying value, or a view if T is std::string_view.
+		 * @exception std::bad_variant_access If the value isn't a T.
+		 */
+		template <typename T>
+		[[nodiscard]] decltype(auto) get() const {
+			if constexpr (std::is_same_v <T, std::string>) {
+				return static_cast <const std::string&>(*std::get <std::shared_ptr <const std::string>>(value));
+			}
+			else if constexpr (std::is_same_v <T, std::string_view>) {
+				return std::string_view(*std::get <std::shared_ptr <const std::string>>(value));
+			}
+			else {
+				return std::get <T>(value);
+			}
+		}
+		/**
+		 * @brief The amount of items of an array or a map.
+		 */
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool contains(std::string_view key) const;
+		/**
+		 * @exception retrieval_exception If there's no such item.
+		 */
+		[[nodiscard]] const snapshot_value& operator [](const size_t& index) const;
+		/**
+		 * @exception retrieval_exception If there's no such key.
+		 */
+		[[nodiscard]] const snapshot_value& operator [](std::string_view key) const;
+		/**
+		 * @brief The keys of a map in insertion order.
+		 */
+		[[nodiscard]] std::vector <std::string_view> keys() const;
+	};
+
+	/**
+	 * @brief A step of a path into a snapshot: a key of a map or an index of an array.
+	 */
+	struct path_item {
+		std::string_view key;
+		size_t index{NPOS};
+		path_item(const char* key) : key(key) {}
+		path_item(const std::string_view key) : key(key) {}
+		path_item(const std::string& key) : key(key) {}
+		template <typename T, std::enable_if_t <std::is_integral_v <T>, int> = 0>
+		path_item(const T index) : index(index) {}
+	};
+
+	using snapshot_path = std::initializer_list <path_item>;
+
+	/**
+	 * @brief An immutable version of a config. Every edit returns a new snapshot which shares all but
+	 * the O(log n) nodes on the edited path with the old one, which stays valid and unchanged for its readers.
+	 * Paths start with the name of a variable, e.g. snap.set({"server", "ports", 0}, 8080).
+	 * @exception retrieval_exception Thrown by the edits if the path doesn't lead anywhere.
+	 */
+	class snapshot_t {
+		snapshot_value root{snapshot_map{}};
+		explicit snapshot_t(snapshot_value root);
+		static snapshot_value from_value(const value_t& x);
+		static value_t to_value(config_t& res, const snapshot_value& x);
+	public:
+		snapshot_t() = default;
+		explicit snapshot_t(const config_t& cfg);
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool contains(std::string_view var) const;
+		[[nodiscard]] const snapshot_value& operator [](std::string_view var) const;
+		[[nodiscard]] std::vector <std::string_view> get_vars() const;
+		/**
+		 * @return The value at the path, or nullptr if there's none.
+		 */
+		[[nodiscard]] const snapshot_value* find(snapshot_path path) const;
+		/**
+		 * @brief Replace the value at the path, or add it if its parent is a map without that key.
+		 */
+		[[nodiscard]] snapshot_t set(snapshot_path path, const snapshot_value& x) const;
+		/**
+		 * @brief Remove a variable, a key of a map or an item of an array.
+		 */
+		[[nodiscard]] snapshot_t erase(snapshot_path path) const;
+		/**
+		 * @brief Append an item to the array at the path.
+		 */
+		[[nodiscard]] snapshot_t push_back(snapshot_path path, const snapshot_value& x) const;
+		/**
+		 * @brief Add a key to the map at the path.
+		 * @exception retrieval_exception If the key is already there.
+		 */
+		[[nodiscard]] snapshot_t insert(snapshot_path path, std::string_view key, const snapshot_value& x) const;
+		/**
+		 * @brief Copy the snapshot into a regular config.
+		 */
+		[[nodiscard]] config_t to_config() const;
+	};
+}
@@ -0,0 +1,933 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "henifig/exception.hpp"
+#include "henifig/types.hpp"
+#include "henifig/value_reader.hpp"
+
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define HENIFIG_CONSTEVAL consteval
+#else
+#define HENIFIG_CONSTEVAL constexpr
+#endif
+
+/**
+ * @brief Parse a Henifig literal while compiling, into read-only data which costs nothing at startup, e.g.
+ * constexpr auto defaults = HENIFIG_STATIC(R"(/port\ | 8080)");
+ * A malformed literal doesn't compile, the compiler pointing at the kind of error it is.
+ * The literal can't @include files.
+ */
+#define HENIFIG_STATIC(text) \
+	::henifig::static_parse <::henifig::detail::static_sizes_of(text).nodes, ::henifig::detail::static_sizes_of(text).chars>(text)
+
+namespace henifig {
+	/**
+	 * @brief A value of a @ref static_config, or a variable of it with its name as the key.
+	 */
+	struct static_node {
+		data_types type{unset};
+		// Strings: where their characters are. Containers: their first item and how many there are.
+		size_t first{}, size{};
+		// The next item of the same container or the next variable.
+		size_t next{NPOS};
+		// The name of a variable or the key of a map entry.
+		size_t key_first{}, key_size{};
+		// Characters and booleans are kept here as well as both kinds of integers.
+		unsigned long long integer{};
+		double floating{};
+	};
+
+	/**
+	 * @brief A read-only view of a value of a @ref static_config, read like a @ref value_t.
+	 */
+	class static_value : public detail::value_reader <static_value> {
+		friend class detail::value_reader <static_value>;
+
+		const static_node* nodes{};
+		const char* chars{};
+		size_t at{};
+
+		[[nodiscard]] constexpr const static_node& node() const {
+			return nodes[at];
+		}
+		[[nodiscard]] constexpr double stored_double() const {
+			return node().floating;
+		}
+		[[nodiscard]] constexpr unsigned long long stored_integer() const {
+			return node().integer;
+		}
+		[[nodiscard]] constexpr size_t find_index(const std::string_view key) const {
+			if (node().type != map) {
+				return NPOS;
+			}
+			for (size_t i = node().first; i != NPOS; i = nodes[i].next) {
+				if (std::string_view(chars + nodes[i].key_first, nodes[i].key_size) == key) {
+					return i;
+				}
+			}
+			return NPOS;
+		}
+	public:
+		constexpr static_value(const static_node* nodes, const char* chars, const size_t& at) : nodes(nodes), chars(chars), at(at) {}
+
+		/**
+		 * @brief An item of an array or the value of the nth entry of a map.
+		 * @exception std::out_of_range If there's no such item.
+		 */
+		[[nodiscard]] constexpr static_value operator [](const size_t& item) const {
+			if ((node().type != array && node().type != map) || item >= node().size) {
+				throw std::out_of_range("static_value::operator []");
+			}
+			size_t res = node().first;
+			for (size_t i = 0; i < item; i++) {
+				res = nodes[res].next;
+			}
+			return {nodes, chars, res};
+		}
+		/**
+		 * @exception std::out_of_range If this isn't a map or the key isn't in it.
+		 */
+		[[nodiscard]] constexpr static_value operator [](const std::string_view key) const {
+			const size_t res = find_index(key);
+			if (res == NPOS) {
+				throw std::out_of_range("static_value::operator []");
+			}
+			return {nodes, chars, res};
+		}
+		[[nodiscard]] constexpr bool contains(const std::string_view key) const {
+			return find_index(key) != NPOS;
+		}
+	};
+
+	namespace detail {
+		constexpr size_t bit_length(unsigned long long x) {
+			size_t res = 0;
+			for (; x; x >>= 1) {
+				++res;
+			}
+			return res;
+		}
+
+		/**
+		 * @brief An unsigned integer wide enough to divide any decimal literal by a power of ten exactly.
+		 */
+		struct static_bigint {
+			// The most digits a literal is read with, shifted past the smallest double, take less than 3700 bits.
+			static constexpr size_t capacity = 128;
+			uint32_t limbs[capacity]{};
+			size_t size{};
+
+			constexpr void trim() {
+				while (size && !limbs[size - 1]) {
+					--size;
+				}
+			}
+			constexpr void multiply_add(const uint32_t factor, const uint32_t addend) {
+				unsigned long long carry = addend;
+				for (size_t i = 0; i < size; i++) {
+					carry += static_cast <unsigned long long>(limbs[i]) * factor;
+					limbs[i] = static_cast <uint32_t>(carry);
+					carry >>= 32;
+				}
+				if (carry) {
+					limbs[size++] = static_cast <uint32_t>(carry);
+				}
+			}
+			constexpr void multiply_power_of_ten(size_t exponent) {
+				for (; exponent >= 9; exponent -= 9) {
+					multiply_add(1000000000, 0);
+				}
+				uint32_t factor = 1;
+				for (; exponent; --exponent) {
+					factor *= 10;
+				}
+				multiply_add(factor, 0);
+			}
+			constexpr void shift_left(const size_t bits) {
+				const size_t whole = bits / 32, part = bits % 32;
+				for (size_t i = size + whole + 1; i-- > whole;) {
+					const uint32_t high = i - whole < size ? limbs[i - whole] : 0;
+					const uint32_t low = i > whole ? limbs[i - whole - 1] : 0;
+					limbs[i] = part ? high << part | low >> (32 - part) : high;
+				}
+				for (size_t i = 0; i < whole; i++) {
+					limbs[i] = 0;
+				}
+				size += whole + 1;
+				trim();
+			}
+			constexpr void halve() {
+				for (size_t i = 0; i < size; i++) {
+					limbs[i] = limbs[i] >> 1 | (i + 1 < size ? limbs[i + 1] << 31 : 0);
+				}
+				trim();
+			}
+			[[nodiscard]] constexpr size_t bit_length() const {
+				return size ? (size - 1) * 32 + detail::bit_length(limbs[size - 1]) : 0;
+			}
+			[[nodiscard]] constexpr bool operator <(const static_bigint& other) const {
+				if (size != other.size) {
+					return size < other.size;
+				}
+				for (size_t i = size; i-- > 0;) {
+					if (limbs[i] != other.limbs[i]) {
+						return limbs[i] < other.limbs[i];
+					}
+				}
+				return false;
+			}
+			/**
+			 * @brief Subtract a number which isn't bigger.
+			 */
+			constexpr void subtract(const static_bigint& other) {
+				unsigned long long borrow = 0;
+				for (size_t i = 0; i < size; i++) {
+					const unsigned long long x = static_cast <unsigned long long>(limbs[i]) - (i < other.size ? other.limbs[i] : 0) - borrow;
+					limbs[i] = static_cast <uint32_t>(x);
+					borrow = x >> 63;
+				}
+				trim();
+			}
+		};
+
+		/**
+		 * @brief Convert decimal digits with or without a dot among them into the nearest double, halfway cases going
+		 * to the even one, the way std::from_chars does at runtime.
+		 * @return Whether it's a double at all, which a value too big or a nonzero one rounding to 0 isn't.
+		 */
+		constexpr bool decimal_to_double(const std::string_view digits, double& res) {
+			// Past this many digits, the rest can only change the rounding by not being all zeros.
+			constexpr size_t max_digits = 768;
+			static_bigint n;
+			// The value is n * 10^exponent.
+			long long exponent = 0;
+			size_t kept = 0;
+			bool dot = false, truncated = false;
+			uint32_t chunk = 0, chunk_scale = 1;
+			for (const char c : digits) {
+				if (c == '.') {
+					dot = true;
+				}
+				else if (!kept && c == '0') {
+					exponent -= dot;
+				}
+				else if (kept == max_digits) {
+					truncated |= c != '0';
+					exponent += !dot;
+				}
+				else {
+					chunk = chunk * 10 + (c - '0');
+					chunk_scale *= 10;
+					++kept;
+					exponent -= dot;
+					if (chunk_scale == 1000000000) {
+						n.multiply_add(chunk_scale, chunk);
+						chunk = 0;
+						chunk_scale = 1;
+					}
+				}
+			}
+			n.multiply_add(chunk_scale, chunk);
+			if (truncated) {
+				// The digits left out round the same way a single 1 after the others does.
+				n.multiply_add(10, 1);
+				--exponent;
+				++kept;
+			}
+			res = 0;
+			if (!n.size) {
+				return true;
+			}
+			// The value is below 10^magnitude but not below a tenth of it: past 10^309 it's too big,
+			// under 10^-324 it's nearer to 0 than to the smallest double.
+			const long long magnitude = static_cast <long long>(kept) + exponent;
+			if (magnitude > 309 || magnitude < -323) {
+				return false;
+			}
+			static_bigint m;
+			m.multiply_add(1, 1);
+			exponent >= 0 ? n.multiply_power_of_ten(exponent) : m.multiply_power_of_ten(-exponent);
+			// Scaling n / m by 2^shift brings it between 2^54 and 2^56, which is more bits than a double keeps.
+			const long long shift = 55 - (static_cast <long long>(n.bit_length()) - static_cast <long long>(m.bit_length()));
+			shift > 0 ? n.shift_left(shift) : m.shift_left(-shift);
+			static_bigint divisor = m;
+			divisor.shift_left(55);
+			unsigned long long quotient = 0;
+			for (int bit = 55; bit >= 0; bit--) {
+				if (!(n < divisor)) {
+					n.subtract(divisor);
+					quotient |= 1ULL << bit;
+				}
+				divisor.halve();
+			}
+			// The value is quotient * 2^-shift, its highest bit being worth 2^top, and a bit more if anything's left.
+			const long long high = static_cast <long long>(bit_length(quotient)) - 1;
+			const long long top = high - shift;
+			// A double keeps 53 bits, fewer for the subnormal ones below 2^-1022.
+			const long long bits = top >= -1022 ? 53 : 53 - (-1022 - top);
+			if (bits < 0) {
+				return false;
+			}
+			const long long dropped = high + 1 - bits;
+			unsigned long long mantissa = quotient >> dropped;
+			const unsigned long long rest = quotient & ((1ULL << dropped) - 1), half = 1ULL << (dropped - 1);
+			mantissa += rest > half || (rest == half && (n.size || mantissa & 1));
+			if (!mantissa) {
+				return false;
+			}
+			long long scale = dropped - shift;
+			if (static_cast <long long>(bit_length(mantissa)) - 1 + scale >= 1024) {
+				return false;
+			}
+			// The mantissa has no more bits than the double being made, so every step is exact.
+			res = static_cast <double>(mantissa);
+			for (; scale > 0; --scale) {
+				res *= 2;
+			}
+			for (; scale < 0; ++scale) {
+				res /= 2;
+			}
+			return true;
+		}
+
+		struct static_sizes {
+			size_t nodes{}, chars{};
+		};
+
+		/**
+		 * @brief Stands in for a @ref static_config to find out how big it needs to be.
+		 */
+		struct static_counter {
+			static_sizes sizes;
+
+			constexpr size_t add_node(const static_node&) {
+				return sizes.nodes++;
+			}
+			constexpr void link(const size_t&, const size_t&) {}
+			constexpr void close(const size_t&, const size_t&, const size_t&) {}
+			constexpr void add_char(const char&) {
+				++sizes.chars;
+			}
+			[[nodiscard]] constexpr size_t char_count() const {
+				return sizes.chars;
+			}
+			[[nodiscard]] constexpr bool has_key(const size_t&, const size_t&, const size_t&) const {
+				return false;
+			}
+		};
+
+		/**
+		 * @brief Reads a Henifig literal the way @ref sax_parser does, writing what it finds into a sink
+		 * which either counts or stores it.
+		 */
+		template <typename Sink>
+		class static_parser {
+			std::string_view text;
+			Sink& out;
+			size_t pos{};
+			size_t line{1};
+			size_t first_var{NPOS}, last_var{NPOS};
+
+			static constexpr bool is_space(const char c) {
+				return c == ' ' || c == '\t' || c == '\r';
+			}
+			static constexpr bool is_punct(const char c) {
+				return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~');
+			}
+			// The end of the text ends whatever a new line would.
+			[[nodiscard]] constexpr char peek(const size_t& offset = 0) const {
+				return pos + offset < text.size() ? text[pos + offset] : '\n';
+			}
+			[[nodiscard]] constexpr bool at_end() const {
+				return pos >= text.size();
+			}
+			constexpr char take() {
+				const char c = peek();
+				line += c == '\n';
+				++pos;
+				return c;
+			}
+			constexpr void fail(const error_codes code) const {
+				if (code != OK) {
+					throw parse_exception(parse_report(code, line));
+				}
+			}
+			/**
+			 * @brief Skip blanks and comments, and new lines too unless a new line ends what's being read.
+			 */
+			constexpr void skip(const bool new_lines) {
+				while (!at_end()) {
+					const char c = peek();
+					if (is_space(c) || (new_lines && c == '\n')) {
+						take();
+					}
+					else if (c == '#') {
+						if (peek(1) == ']') {
+							fail(NO_OPENED_COMMENT);
+						}
+						while (!at_end() && peek() != '\n') {
+							take();
+						}
+					}
+					else if (c == '[' && peek(1) == '#') {
+						block_comment();
+					}
+					else {
+						break;
+					}
+				}
+			}
+			constexpr void block_comment() {
+				const size_t comment_line = line;
+				pos += 2;
+				if (peek() == ']') {
+					fail(IMPROPERLY_CLOSED_COMMENT);
+				}
+				while (!at_end() && !(peek() == '#' && peek(1) == ']')) {
+					take();
+				}
+				if (at_end()) {
+					line = comment_line;
+					fail(HANGING_COMMENT);
+				}
+				pos += 2;
+			}
+			/**
+			 * @brief Read a comment right after a token before saying what's wrong with the token,
+			 * sax_parser only seeing the token end once the comment does.
+			 */
+			constexpr void adjacent_comment() {
+				if (peek() == '#' && peek(1) == ']') {
+					fail(NO_OPENED_COMMENT);
+				}
+				if (peek() == '[' && peek(1) == '#') {
+					block_comment();
+				}
+			}
+			// The new line ending a literal too soon is on the line of the literal, so it's looked at before being read.
+			constexpr char escape() {
+				const char c = peek();
+				if (c == ' ' || c == '\n') {
+					fail(HANGING_ESCAPE);
+				}
+				if (c != 'n' && !is_punct(c)) {
+					fail(UNDEFINED_ESCAPE);
+				}
+				++pos;
+				return c == 'n' ? '\n' : c;
+			}
+			/**
+			 * @brief Read the characters of a quoted literal up to its closing quote, the opening one being read already.
+			 * @param literal_line Where the literal began, adjacent strings making up a single one.
+			 */
+			constexpr void quoted(const size_t& literal_line) {
+				while (true) {
+					const char c = peek();
+					if (c == '\n') {
+						line = literal_line;
+						fail(HANGING_QUOTE);
+					}
+					++pos;
+					if (c == '"') {
+						return;
+					}
+					out.add_char(c == '\\' ? escape() : c);
+				}
+			}
+			[[nodiscard]] constexpr bool has_var(const size_t& key_first, const size_t& key_size) const {
+				return first_var != NPOS && out.has_key(first_var, key_first, key_size);
+			}
+			constexpr void add_var(const size_t& node) {
+				last_var == NPOS ? void(first_var = node) : out.link(last_var, node);
+				last_var = node;
+			}
+			static constexpr double power_of_ten(const size_t& exponent) {
+				double res = 1;
+				for (size_t i = 0; i < exponent; i++) {
+					res *= 10;
+				}
+				return res;
+			}
+			constexpr static_node number() {
+				const bool negative = peek() == '-';
+				bool is_float = false;
+				size_t digits = 0, fraction = 0;
+				unsigned long long mantissa = 0;
+				bool overflow = false;
+				if (negative) {
+					++pos;
+				}
+				const size_t first = pos;
+				for (char c = peek(); (c >= '0' && c <= '9') || c == '.' || c == '-'; c = peek()) {
+					if (c == '-') {
+						fail(MINUS_IN_MIDDLE);
+					}
+					++pos;
+					if (c == '.') {
+						if (is_float) {
+							fail(REPEATED_DOT);
+						}
+						is_float = true;
+						continue;
+					}
+					const unsigned long long digit = c - '0';
+					overflow |= mantissa > (~0ULL - digit) / 10;
+					mantissa = mantissa * 10 + digit;
+					++digits;
+					fraction += is_float;
+				}
+				const auto fail_number = [this](const error_codes code) {
+					adjacent_comment();
+					fail(code);
+				};
+				if (text[pos - 1] == '.' || !digits) {
+					fail_number(text[pos - 1] == '.' ? HANGING_DOT : EXPECTED_EXPRESSION);
+				}
+				static_node res;
+				if (is_float) {
+					res.type = floating;
+					// A whole number and a power of ten which are both exact doubles are divided with a single rounding,
+					// the rest takes exact arithmetic to round the way from_chars does at runtime.
+					if (!overflow && mantissa <= (1ULL << 53) && fraction <= 22) {
+						res.floating = static_cast <double>(mantissa) / power_of_ten(fraction);
+					}
+					else if (!decimal_to_double(text.substr(first, pos - first), res.floating)) {
+						fail_number(WRONG_EXPRESSION);
+					}
+					res.floating = negative ? -res.floating : res.floating;
+				}
+				else if (negative) {
+					if (overflow || mantissa > (1ULL << 63)) {
+						fail_number(WRONG_EXPRESSION);
+					}
+					res.type = longlong;
+					res.integer = 0 - mantissa;
+				}
+				else {
+					if (overflow) {
+						fail_number(WRONG_EXPRESSION);
+					}
+					res.type = ulonglong;
+					res.integer = mantissa;
+				}
+				return res;
+			}
+			/**
+			 * @brief Read a value beginning at the current character and add it.
+			 * @param frame The type of the container it's in, unset at the top.
+			 * @param newline_after Whether a string ended up reading the end of its line, which ends a variable.
+			 */
+			constexpr size_t value(const data_types& frame, static_node res, bool& newline_after) {
+				newline_after = false;
+				const char c = peek();
+				switch (c) {
+					case '"': {
+						res.type = string;
+						res.first = out.char_count();
+						const size_t literal_line = line;
+						while (peek() == '"') {
+							++pos;
+							quoted(literal_line);
+							// Adjacent strings make up a single one.
+							const size_t before = line;
+							skip(true);
+							newline_after |= line != before;
+						}
+						res.size = out.char_count() - res.first;
+						return out.add_node(res);
+					}
+					case '\'': {
+						++pos;
+						char x = peek();
+						if (x == '\'') {
+							fail(NO_CHARS);
+						}
+						if (x == '\n') {
+							fail(HANGING_APOSTROPHE);
+						}
+						++pos;
+						if (x == '\\') {
+							x = escape();
+						}
+						const char end = peek();
+						if (end == '\n') {
+							fail(HANGING_APOSTROPHE);
+						}
+						if (end != '\'') {
+							fail(MULTIPLE_CHARS);
+						}
+						++pos;
+						res.type = character;
+						res.integer = static_cast <unsigned char>(x);
+						return out.add_node(res);
+					}
+					case '[':
+					case '{': {
+						++pos;
+						return container(c == '[' ? array : map, res);
+					}
+					case 't':
+					case 'f': {
+						const std::string_view keyword = c == 't' ? "true" : "false";
+						for (const char x : keyword) {
+							if (peek() != x) {
+								adjacent_comment();
+								fail(UNKNOWN_EXPRESSION);
+							}
+							++pos;
+						}
+						res.type = boolean;
+						res.integer = c == 't';
+						return out.add_node(res);
+					}
+					case '$': {
+						fail(UNEXPECTED_DOLLAR);
+						break;
+					}
+					case ']': {
+						fail(frame == map ? MAP_COMPLETED_WITH_ARR : UNEXPECTED_ARR_END);
+						break;
+					}
+					case '}': {
+						fail(frame == array ? ARR_COMPLETED_WITH_MAP : UNEXPECTED_MAP_END);
+						break;
+					}
+					default: {
+						if (!((c >= '0' && c <= '9') || c == '-' || c == '.')) {
+							fail(UNKNOWN_EXPRESSION);
+						}
+						const static_node x = number();
+						res.type = x.type;
+						res.integer = x.integer;
+						res.floating = x.floating;
+						return out.add_node(res);
+					}
+				}
+				return NPOS;
+			}
+			/**
+			 * @brief Read the items of a container up to its end, the opening bracket being read already.
+			 */
+			constexpr size_t container(const data_types& type, static_node res) {
+				const size_t open_line = line;
+				res.type = type;
+				const size_t node = out.add_node(res);
+				size_t first = NPOS, last = NPOS, size = 0;
+				const auto add = [&](const size_t& item) {
+					last == NPOS ? void(first = item) : out.link(last, item);
+					last = item;
+					++size;
+				};
+				bool newline_after = false;
+				// The input ending anywhere inside leaves the container hanging.
+				const auto skip_inside = [&]() {
+					skip(true);
+					if (at_end()) {
+						line = open_line;
+						fail(type == array ? HANGING_ARR : HANGING_MAP);
+					}
+				};
+				for (bool next = false;; next = true) {
+					skip_inside();
+					const char c = peek();
+					if (c == (type == array ? ']' : '}')) {
+						if (next) {
+							fail(HANGING_COMMA);
+						}
+						++pos;
+						break;
+					}
+					if (c == ',') {
+						fail(next ? EXPECTED_EXPRESSION : UNEXPECTED_COMMA);
+					}
+					if (type == array) {
+						add(value(array, static_node{}, newline_after));
+					}
+					else {
+						if (c != '$') {
+							fail(EXPECTED_DOLLAR);
+						}
+						++pos;
+						if (peek() != '"') {
+							const error_codes code = peek() == '$' ? REPEATED_DOLLAR : HANGING_DOLLAR;
+							adjacent_comment();
+							fail(code);
+						}
+						++pos;
+						static_node entry;
+						entry.key_first = out.char_count();
+						quoted(line);
+						entry.key_size = out.char_count() - entry.key_first;
+						if (first != NPOS && out.has_key(first, entry.key_first, entry.key_size)) {
+							fail(REDECLARED_KEY);
+						}
+						skip_inside();
+						if (peek() == '|') {
+							++pos;
+							skip_inside();
+							const char x = peek();
+							if (x == '$') {
+								fail(PIPED_KEY);
+							}
+							if (x == ',' || x == '}' || x == '|') {
+								fail(HANGING_PIPE);
+							}
+							add(value(map, entry, newline_after));
+						}
+						else if (peek() == ',' || peek() == '}') {
+							// A key without a value is a declaration.
+							entry.type = declaration;
+							add(out.add_node(entry));
+						}
+						else {
+							fail(UNEXPECTED_EXPRESSION);
+						}
+					}
+					skip(true);
+					const char x = peek();
+					if (at_end() || x == '\\') {
+						line = open_line;
+						fail(type == array ? HANGING_ARR : HANGING_MAP);
+					}
+					if (x == (type == array ? ']' : '}')) {
+						++pos;
+						break;
+					}
+					if (x != ',') {
+						if (type == array) {
+							fail(x == '}' ? ARR_COMPLETED_WITH_MAP : UNEXPECTED_EXPRESSION);
+						}
+						fail(x == ']' ? MAP_COMPLETED_WITH_ARR : x == '|' ? PIPED_VALUE : UNEXPECTED_EXPRESSION);
+					}
+					++pos;
+				}
+				out.close(node, first, size);
+				return node;
+			}
+			constexpr void var() {
+				++pos;
+				static_node res;
+				res.key_first = out.char_count();
+				char c{};
+				while (true) {
+					c = peek();
+					if (c == '\\') {
+						++pos;
+						if (peek() != '\\') {
+							break;
+						}
+						++pos;
+						out.add_char('\\');
+					}
+					// Like sax_parser, a name is everything up to a backslash, a bracket or the end of the line, '#' included.
+					else if (c == '[' || c == '{') {
+						break;
+					}
+					else if (c == '\n') {
+						fail(HANGING_VAR);
+					}
+					else {
+						++pos;
+						out.add_char(c);
+					}
+				}
+				res.key_size = out.char_count() - res.key_first;
+				if (has_var(res.key_first, res.key_size)) {
+					fail(REDECLARED_VAR);
+				}
+				if (c == '[' || c == '{') {
+					++pos;
+					add_var(container(c == '[' ? array : map, res));
+					skip(false);
+					if (peek() != '\\') {
+						fail(HANGING_VAR);
+					}
+					++pos;
+					return;
+				}
+				skip(false);
+				c = peek();
+				if (c == '\n' || c == ';' || c == '/') {
+					res.type = declaration;
+					add_var(out.add_node(res));
+					return;
+				}
+				if (c != '|') {
+					fail(UNEXPECTED_EXPRESSION);
+				}
+				++pos;
+				skip(true);
+				c = peek();
+				if (c == '/' || c == '|' || c == ';' || at_end()) {
+					fail(HANGING_PIPE);
+				}
+				if (c == '[' || c == '{') {
+					fail(c == '[' ? UNEXPECTED_ARR : UNEXPECTED_MAP);
+				}
+				bool newline_after = false;
+				add_var(value(unset, res, newline_after));
+				if (newline_after) {
+					return;
+				}
+				skip(false);
+				c = peek();
+				if (c != '\n' && c != ';') {
+					fail(c == '/' ? MISSING_SEMICOLON : UNEXPECTED_EXPRESSION);
+				}
+			}
+		public:
+			constexpr static_parser(const std::string_view text, Sink& out) : text(text), out(out) {}
+
+			/**
+			 * @return The first variable.
+			 */
+			constexpr size_t parse() {
+				while (true) {
+					skip(true);
+					while (peek() == ';' && !at_end()) {
+						++pos;
+						skip(true);
+					}
+					if (at_end()) {
+						return first_var;
+					}
+					const char c = peek();
+					if (c == '/') {
+						var();
+					}
+					else {
+						// Files can't be read while compiling, so neither can @include.
+						fail(c == '|' ? NAKED_PIPE : c == '@' ? UNEXPECTED_EXPRESSION : UNKNOWN_EXPRESSION);
+					}
+				}
+			}
+		};
+
+		constexpr static_sizes static_sizes_of(const std::string_view text) {
+			static_counter counter;
+			static_parser <static_counter>(text, counter).parse();
+			return counter.sizes;
+		}
+	}
+
+	/**
+	 * @brief A config parsed while compiling, see @ref HENIFIG_STATIC. Its values are read through @ref static_value.
+	 */
+	template <size_t Nodes, size_t Chars>
+	class static_config {
+		std::array <static_node, Nodes> nodes{};
+		std::array <char, Chars> chars{};
+		size_t node_count{}, chars_count{};
+		size_t first_var{NPOS}, var_count{};
+
+		[[nodiscard]] constexpr size_t find_index(const std::string_view var) const {
+			for (size_t i = first_var; i != NPOS; i = nodes[i].next) {
+				if (std::string_view(chars.data() + nodes[i].key_first, nodes[i].key_size) == var) {
+					return i;
+				}
+			}
+			return NPOS;
+		}
+		template <typename Sink>
+		friend class detail::static_parser;
+		template <size_t N, size_t C>
+		friend HENIFIG_CONSTEVAL static_config <N, C> static_parse(std::string_view text);
+
+		constexpr size_t add_node(const static_node& x) {
+			nodes[node_count] = x;
+			return node_count++;
+		}
+		constexpr void link(const size_t& prev, const size_t& next) {
+			nodes[prev].next = next;
+		}
+		constexpr void close(const size_t& container, const size_t& first, const size_t& size) {
+			nodes[container].first = first;
+			nodes[container].size = size;
+		}
+		constexpr void add_char(const char& c) {
+			chars[chars_count++] = c;
+		}
+		[[nodiscard]] constexpr size_t char_count() const {
+			return chars_count;
+		}
+		[[nodiscard]] constexpr bool has_key(const size_t& first, const size_t& key_first, const size_t& key_size) const {
+			const std::string_view key(chars.data() + key_first, key_size);
+			for (size_t i = first; i != NPOS; i = nodes[i].next) {
+				if (std::string_view(chars.data() + nodes[i].key_first, nodes[i].key_size) == key) {
+					return true;
+				}
+			}
+			return false;
+		}
+	public:
+		/**
+		 * @brief How many variables there are.
+		 */
+		[[nodiscard]] constexpr size_t size() const {
+			return var_count;
+		}
+		[[nodiscard]] constexpr bool contains(const std::string_view var) const {
+			return find_index(var) != NPOS;
+		}
+		/**
+		 * @exception std::out_of_range If there's no such variable.
+		 */
+		[[nodiscard]] constexpr static_value operator [](const std::string_view var) const {
+			const size_t res = find_index(var);
+			if (res == NPOS) {
+				throw std::out_of_range("static_config::operator []");
+			}
+			return {nodes.data(), chars.data(), res};
+		}
+		/**
+		 * @brief The nth variable, in the order they're written in.
+		 * @exception std::out_of_range If there's no such variable.
+		 */
+		[[nodiscard]] constexpr static_value get_value(const size_t& var) const {
+			if (var >= var_count) {
+				throw std::out_of_range("static_config::get_value");
+			}
+			size_t res = first_var;
+			for (size_t i = 0; i < var; i++) {
+				res = nodes[res].next;
+			}
+			return {nodes.data(), chars.data(), res};
+		}
+	};
+
+	/**
+	 * @brief Parse a literal into a config of the given sizes, which @ref HENIFIG_STATIC works out.
+	 */
+	template <size_t Nodes, size_t Chars>
+	HENIFIG_CONSTEVAL static_config <Nodes, Chars> static_parse(const std::string_view text) {
+		static_config <Nodes, Chars> res;
+		res.first_var = detail::static_parser <static_config <Nodes, Chars>>(text, res).parse();
+		for (size_t i = res.first_var; i != NPOS; i = res.nodes[i].next) {
+			++res.var_count;
+		}
+		return res;
+	}
+}
@@ -0,0 +1,130 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace henifig {
+	class config_t;
+	class string_pool;
+	class string_views;
+
+	/**
+	 * @brief A handle to a string stored once in a @ref string_pool, or left in a caller's buffer by @ref string_views.
+	 * Handles coming from the same pool are compared by pointer; handles from different pools,
+	 * borrowed ones and plain strings are compared by content.
+	 */
+	class istring {
+		struct entry {
+			std::string_view text;
+			// Only filled in for a borrowed string once it's asked for as a std::string.
+			mutable std::string str;
+			mutable std::once_flag copied;
+			const string_pool* pool{};
+			bool borrowed{};
+
+			entry(std::string_view text, const string_pool* pool, const bool& borrowed);
+		};
+		static const entry empty;
+		const entry* node{&empty};
+		explicit istring(const entry* node);
+		friend class string_pool;
+		friend class string_views;
+	public:
+		istring() = default;
+		operator const std::string&() const;
+		operator std::string_view() const;
+		[[nodiscard]] const std::string& get() const;
+		[[nodiscard]] std::string_view view() const;
+		[[nodiscard]] const char* data() const;
+		[[nodiscard]] size_t size() const;
+		/**
+		 * @brief The pool the string is stored in, nullptr for a default-constructed or borrowed handle.
+		 */
+		[[nodiscard]] const string_pool* owner() const;
+		[[nodiscard]] bool operator ==(const istring& other) const;
+		[[nodiscard]] bool operator !=(const istring& other) const;
+		[[nodiscard]] bool operator ==(std::string_view other) const;
+		[[nodiscard]] bool operator !=(std::string_view other) const;
+		[[nodiscard]] bool operator <(const istring& other) const;
+		[[nodiscard]] bool operator <(std::string_view other) const;
+		friend bool operator <(std::string_view lhs, const istring& rhs);
+	};
+
+	bool operator <(std::string_view lhs, const istring& rhs);
+	std::ostream& operator <<(std::ostream& os, const istring& str);
+
+	/**
+	 * @brief Stores every distinct string once. A pool can be shared between configs (and threads).
+	 */
+	class string_pool {
+		mutable std::mutex mutex;
+		std::deque <istring::entry> strings;
+		std::unordered_map <std::string_view, const istring::entry*> index;
+		size_t stored_bytes{}, requested{};
+
+		/**
+		 * @brief Drop every string, leaving dangling every istring handed out. Only a config owning its pool alone does it.
+		 */
+		void clear();
+		friend class config_t;
+	public:
+		string_pool() = default;
+		string_pool(const string_pool&) = delete;
+		string_pool& operator=(const string_pool&) = delete;
+
+		/**
+		 * @brief Get the handle to the pooled copy of a string, adding it to the pool if it's not there yet.
+		 */
+		istring intern(std::string_view str);
+		/**
+		 * @brief The amount of distinct strings in the pool.
+		 */
+		[[nodiscard]] size_t size() const;
+		/**
+		 * @brief The amount of characters stored in the pool.
+		 */
+		[[nodiscard]] size_t bytes() const;
+		/**
+		 * @brief The amount of characters passed to @ref intern, duplicates included.
+		 */
+		[[nodiscard]] size_t requested_bytes() const;
+		/**
+		 * @brief The process-wide pool, to share strings between all the configs using it.
+		 */
+		static const std::shared_ptr <string_pool>& global();
+	};
+
+	/**
+	 * @brief Hands out istrings for strings which stay in a buffer owned by someone else, which must outlive them.
+	 * Nothing is copied unless a string is asked for as a std::string or through istring::data, which need it NUL-terminated.
+	 */
+	class string_views {
+		// Only made for the first string, for an unused one not to allocate.
+		std::unique_ptr <std::deque <istring::entry>> strings;
+	public:
+		istring view(std::string_view str);
+		void clear();
+		[[nodiscard]] size_t size() const;
+	};
+}
@@ -22,14 +22,20 @@
 #include <iostream>
 #include <algorithm>
 #include <cstring>
+#include <deque>
 #include <sstream>
 #include <variant>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <stack>
 #include <type_traits>
 #include <unordered_map>
 
 #include "henifig/errors.hpp"
+#include "henifig/locations.hpp"
+#include "henifig/options.hpp"
+#include "henifig/string_pool.hpp"
 
 namespace henifig {
 	/**
@@ -48,17 +54,6 @@ namespace henifig {
 		map,			// {map}
 	};
 
-	/**
-	 * @brief The type of the value at the <current index>
-	 */
-	enum index_types : uint8_t {
-		VAR,			// variable
-		ARR,			// array
-		MAP,			// map
-		ARR_ITEM,		// array item
-		MAP_KEY,		// a key inside a map
-		MAP_VALUE,		// a value inside a map
-	};
 	constexpr size_t NPOS = -1;
 	struct declaration_t{};
 	struct unset_t{};
@@ -66,22 +61,183 @@ namespace henifig {
 	struct array_t;
 	struct map_t;
 	class value_t;
+	class value_map;
 
-	using value_map = std::map <std::string, value_t>;
 	using value_variant = std::variant
-	<unset_t, declaration_t, std::string, char, double, unsigned long long, long long, bool, array_t, map_t>;
+	<unset_t, declaration_t, istring, char, double, unsigned long long, long long, bool, array_t, map_t>;
 
 	using value_array = std::vector <value_t>;
 
+	/**
+	 * @brief A map of values keyed by interned strings, kept in insertion order.
+	 * The entries are stored contiguously; maps bigger than a few entries also keep an open-addressing hash index.
+	 * Keys are read-only, like those of a std::map, for the index to stay right.
+	 */
+	class value_map {
+	public:
+		using key_type = istring;
+		using mapped_type = value_t;
+		using value_type = std::pair <const istring, value_t>;
+		using iterator = std::vector <value_type>::iterator;
+		using const_iterator = std::vector <value_type>::const_iterator;
+	private:
+		static constexpr size_t index_threshold = 8;
+		std::vector <value_type> entries;
+		std::vector <uint32_t> slots; // entry index + 1, 0 for an empty slot
+		template <typename K>
+		[[nodiscard]] size_t find_index(const K& key, std::string_view view) const;
+		void index_entry(const size_t& entry);
+		void rehash(const size_t& slot_count);
+	public:
+		value_map() = default;
+		[[nodiscard]] iterator begin();
+		[[nodiscard]] iterator end();
+		[[nodiscard]] const_iterator begin() const;
+		[[nodiscard]] const_iterator end() const;
+		[[nodiscard]] size_t size() const;
+		[[nodiscard]] bool empty() const;
+		[[nodiscard]] iterator find(std::string_view key);
+		[[nodiscard]] const_iterator find(std::string_view key) const;
+		[[nodiscard]] size_t count(std::string_view key) const;
+		[[nodiscard]] bool contains(std::string_view key) const;
+		[[nodiscard]] value_t& at(std::string_view key);
+		[[nodiscard]] const value_t& at(std::string_view key) const;
+		/**
+		 * @brief Get the value of a key, appending an unset value if the key isn't there yet.
+		 */
+		value_t& operator [](const istring& key);
+		void reserve(const size_t& size);
+		void shrink_to_fit();
+		void clear();
+	};
+
+	/**
+	 * @brief A read-only view of contiguous items.
+	 */
+	template <typename T>
+	class span {
+		T* first{};
+		size_t count{};
+	public:
+		span() = default;
+		span(T* first, const size_t& count) : first(first), count(count) {}
+		[[nodiscard]] T* begin() const {
+			return first;
+		}
+		[[nodiscard]] T* end() const {
+			return first + count;
+		}
+		[[nodiscard]] T* data() const {
+			return first;
+		}
+		[[nodiscard]] size_t size() const {
+			return count;
+		}
+		[[nodiscard]] bool empty() const {
+			return !count;
+		}
+		[[nodiscard]] T& operator [](const size_t& index) const {
+			return first[index];
+		}
+	};
+
+	/**
+	 * @brief The items of an array which all have the same numeric or boolean type, stored contiguously.
+	 */
+	class packed_array {
+		std::variant <std::monostate, std::unique_ptr <double[]>, std::unique_ptr <unsigned long long[]>,
+		std::unique_ptr <long long[]>, std::unique_ptr <bool[]>> items;
+		// Packed arrays are never empty, an empty one only keeps its storage for later.
+		size_t count{}, capacity{};
+	public:
+		packed_array() = default;
+		/**
+		 * @brief Make room for the given amount of T, reusing the storage if it's big enough already.
+		 * @return The storage to fill.
+		 */
+		template <typename T>
+		T* assign(const size_t& size) {
+			count = size;
+			if (!std::holds_alternative <std::unique_ptr <T[]>>(items) || capacity < size) {
+				capacity = size;
+				return items.emplace <std::unique_ptr <T[]>>(new T[size]).get();
+			}
+			return std::get <std::unique_ptr <T[]>>(items).get();
+		}
+		/**
+		 * @brief Add an item, growing the storage geometrically. The items already there must be T's too.
+		 */
+		template <typename T>
+		void push_back(const T& x) {
+			if (!std::holds_alternative <std::unique_ptr <T[]>>(items)) {
+				count = capacity = 0;
+				items.emplace <std::unique_ptr <T[]>>();
+			}
+			std::unique_ptr <T[]>& storage = std::get <std::unique_ptr <T[]>>(items);
+			if (count == capacity) {
+				capacity = std::max <size_t>(capacity * 2, 8);
+				std::unique_ptr <T[]> grown(new T[capacity]);
+				std::copy(storage.get(), storage.get() + count, grown.get());
+				storage = std::move(grown);
+			}
+			storage[count++] = x;
+		}
+		/**
+		 * @brief Give back the storage past the last item.
+		 */
+		void shrink_to_fit();
+		/**
+		 * @brief Unpack the array, keeping the storage.
+		 */
+		void clear();
+		/**
+		 * @brief The type of the items, or unset if the array isn't packed.
+		 */
+		[[nodiscard]] data_types type() const;
+		[[nodiscard]] size_t size() const;
+		template <typename T>
+		[[nodiscard]] bool is() const {
+			return count && std::holds_alternative <std::unique_ptr <T[]>>(items);
+		}
+		template <typename T>
+		[[nodiscard]] span <const T> get() const {
+			return {std::get <std::unique_ptr <T[]>>(items).get(), count};
+		}
+		[[nodiscard]] value_t at(const size_t& index) const;
+	};
+
+	/**
+	 * @brief An array owned by a config. Packed arrays only get boxed into value_t's when asked to.
+	 */
+	struct array_data {
+		mutable value_array items;
+		packed_array packed;
+		mutable std::once_flag boxed;
+		[[nodiscard]] const value_array& get() const;
+		/**
+		 * @brief Empty the array to be filled again, keeping the memory it holds.
+		 */
+		void clear();
+	};
+
+	/**
+	 * @brief Refers to an array owned by a config. The config keeps its containers at stable addresses.
+	 */
 	struct array_t {
-		size_t index{};
-		const config_t* cfg{};
+		const array_data* data{};
 		operator const value_array&() const;
 		[[nodiscard]] const value_array& get() const;
+		[[nodiscard]] const packed_array& packed() const;
+		/**
+		 * @brief The amount of items, without boxing a packed array.
+		 */
+		[[nodiscard]] size_t size() const;
 	};
+	/**
+	 * @brief Refers to a map owned by a config. The config keeps its containers at stable addresses.
+	 */
 	struct map_t {
-		size_t index{};
-		const config_t* cfg{};
+		const value_map* items{};
 		operator const value_map&() const;
 		[[nodiscard]] const value_map& get() const;
 	};
@@ -95,8 +251,34 @@ namespace henifig {
 		constexpr bool is_alternative(type_identity <std::variant <Args...>>, type_identity <T>) {
 			return (std::is_same_v <Args, T> || ...);
 		}
+		template <typename T>
+		struct stored {
+			using type = T;
+		};
+		template <>
+		struct stored <std::string> {
+			using type = istring;
+		};
+		template <>
+		struct stored <std::string_view> {
+			using type = istring;
+		};
+		template <>
+		struct stored <value_array> {
+			using type = array_t;
+		};
+		template <>
+		struct stored <value_map> {
+			using type = map_t;
+		};
 	}
 
+	/**
+	 * @brief The alternative of value_variant that holds a T.
+	 */
+	template <typename T>
+	using stored_t = typename detail::stored <T>::type;
+
 	template <typename T>
 	constexpr inline bool in_variant = detail::is_alternative(detail::type_identity <value_variant>{}, detail::type_identity <T>{});
 
@@ -104,7 +286,11 @@ namespace henifig {
 	constexpr inline bool convertible_to_variant = in_variant <T> || detail::is_alternative(detail::type_identity <std::variant <Args...>>{}, detail::type_identity <T>{});
 
 	template <typename T>
-	constexpr inline bool convertible_to_ref = convertible_to_variant <T, value_array, value_map>;
+	constexpr inline bool convertible_to_ref = convertible_to_variant <T, std::string, value_array, value_map>;
+
+	// Scalars are converted by value, otherwise GCC can't pick between the two conversion operators.
+	template <typename T>
+	constexpr inline bool convertible_to_class_ref = convertible_to_ref <T> && std::is_class_v <T>;
 
 	template <class T, template <class...> class Template>
 	struct is_specialisation : std::false_type {};
@@ -128,19 +314,25 @@ namespace henifig {
 		operator const value_variant&() const;
 
 		/**
-		 * @brief Get a reference to the underlying value.
+		 * @brief Get a reference to the underlying value, or a view if T is std::string_view.
 		 * @tparam T The type to get a reference to.
 		 * @return A reference to the underlying value.
 		 * @exception std::bad_variant_access If a reference to T can't refer to the underlying variable.
 		 */
-		template <typename T, typename = std::enable_if_t <convertible_to_ref <T>>>
-		[[nodiscard]] const T& get() const {
-			if constexpr (std::is_same_v <T, value_array>) {
+		template <typename T, typename = std::enable_if_t <convertible_to_ref <T> || std::is_same_v <T, std::string_view>>>
+		[[nodiscard]] decltype(auto) get() const {
+			if constexpr (std::is_same_v <T, std::string_view>) {
+				return std::get <istring>(value).view();
+			}
+			else if constexpr (std::is_same_v <T, value_array>) {
 				return std::get <array_t>(value).get();
 			}
 			else if constexpr (std::is_same_v <T, value_map>) {
 				return std::get <map_t>(value).get();
 			}
+			else if constexpr (std::is_same_v <T, std::string>) {
+				return std::get <istring>(value).get();
+			}
 			else {
 				return std::get <T>(value);
 			}
@@ -150,7 +342,7 @@ namespace henifig {
 		 * @brief Convert self to the type of the underlying value through @ref get.
 		 * @tparam T The type to convert to.
 		 */
-		template <typename T, typename = std::enable_if_t <convertible_to_ref <T>>>
+		template <typename T, typename = std::enable_if_t <convertible_to_class_ref <T>>>
 		[[nodiscard]] operator const T&() const {
 			return get <T>();
 		}
@@ -159,7 +351,7 @@ namespace henifig {
 		 * @brief Convert self to the type compatible with that of the underlying value through @ref get.
 		 * @tparam T The type to convert to.
 		 */
-		template <typename T, typename = std::enable_if_t <!convertible_to_ref <T>>>
+		template <typename T, typename = std::enable_if_t <!convertible_to_class_ref <std::decay_t <T>>>>
 		[[nodiscard]] operator T() const {
 			if constexpr (!std::is_same_v <T, bool> &&
 			!std::is_same_v <T, char> &&
@@ -174,21 +366,15 @@ namespace henifig {
 					return std::get <long long>(value);
 				}
 			}
-			else if constexpr (std::is_convertible_v <const char*, T> && !std::is_same_v <T, std::string>) {
-				return std::get <std::string>(value).data();
+			else if constexpr (std::is_pointer_v <T> && std::is_convertible_v <const char*, T>) {
+				return std::get <istring>(value).data();
 			}
-			else if constexpr (is_vector <T>) {
-				T res;
-				for (const value_t& x : this->get <value_array>()) {
-					res.push_back(x);
-				}
-				return res;
+			else if constexpr (std::is_same_v <T, std::string_view>) {
+				return std::get <istring>(value).view();
 			}
-			else if constexpr (is_map <T>) {
+			else if constexpr (is_vector <T> || is_map <T>) {
 				T res;
-				for (const auto& x : this->get <value_map>()) {
-					res[x.first] = static_cast <typename T::mapped_type>(x.second);
-				}
+				extract(res);
 				return res;
 			}
 			else {
@@ -197,6 +383,92 @@ namespace henifig {
 			}
 		}
 
+		/**
+		 * @brief Convert self into an existing object, reusing its storage.
+		 * Containers are cleared, sized up front and filled in place; nested containers are filled the same way.
+		 * @tparam T The type to convert to, anything @ref operator T() accepts.
+		 * @exception std::bad_variant_access If the value (or one of its items) can't be converted to T.
+		 */
+		template <typename T>
+		void extract(T& out) const {
+			if constexpr (is_vector <T>) {
+				using item_type = typename T::value_type;
+				if constexpr (std::is_arithmetic_v <item_type>) {
+					out.resize(std::get <array_t>(value).size());
+					copy_to <item_type>(out.begin());
+				}
+				else {
+					const value_array& items = get <value_array>();
+					out.resize(items.size());
+					for (size_t i = 0; i < items.size(); i++) {
+						items[i].extract(out[i]);
+					}
+				}
+			}
+			else if constexpr (is_map <T>) {
+				const value_map& items = get <value_map>();
+				out.clear();
+				if constexpr (is_specialisation <T, std::unordered_map>::value) {
+					out.reserve(items.size());
+				}
+				for (const auto& [key, item] : items) {
+					item.extract(out[key.get()]);
+				}
+			}
+			else if constexpr (convertible_to_class_ref <T>) {
+				out = get <T>();
+			}
+			else {
+				out = static_cast <T>(*this);
+			}
+		}
+
+		/**
+		 * @brief Write the items of an array to an output iterator as T.
+		 * The type of a packed array is checked once and its items are copied in a single loop.
+		 * @return The iterator past the last written item.
+		 * @exception std::bad_variant_access If the value isn't an array or an item can't be converted to T.
+		 */
+		template <typename T, typename OutputIt>
+		OutputIt copy_to(OutputIt out) const {
+			const array_t& arr = std::get <array_t>(value);
+			if constexpr (std::is_arithmetic_v <T>) {
+				const packed_array& packed = arr.packed();
+				const data_types type = packed.type();
+				if (type != unset) {
+					// The same pairs of types @ref operator T() accepts.
+					if constexpr (std::is_same_v <T, bool>) {
+						if (type == boolean) {
+							return std::copy(packed.get <bool>().begin(), packed.get <bool>().end(), out);
+						}
+					}
+					else if constexpr (std::is_floating_point_v <T>) {
+						if (type == floating) {
+							return std::copy(packed.get <double>().begin(), packed.get <double>().end(), out);
+						}
+					}
+					else if constexpr (!std::is_same_v <T, char>) {
+						if (type == ulonglong) {
+							return std::copy(packed.get <unsigned long long>().begin(), packed.get <unsigned long long>().end(), out);
+						}
+						if (type == longlong) {
+							return std::copy(packed.get <long long>().begin(), packed.get <long long>().end(), out);
+						}
+					}
+					throw std::bad_variant_access();
+				}
+			}
+			for (const value_t& item : arr.get()) {
+				if constexpr (convertible_to_class_ref <T>) {
+					*out++ = item.get <T>();
+				}
+				else {
+					*out++ = static_cast <T>(item);
+				}
+			}
+			return out;
+		}
+
 		template <typename T>
 		value_t& operator =(const T& val) {
 			value = val;
@@ -215,31 +487,127 @@ namespace henifig {
 		[[nodiscard]] bool operator !=(const T& val) const {
 			return !(*this == val);
 		}
+		/**
+		 * @brief Check whether the value is an array stored packed as T.
+		 * @tparam T double, unsigned long long, long long or bool.
+		 */
+		template <typename T>
+		[[nodiscard]] bool is_packed() const {
+			return value.index() == array && std::get <array_t>(value).packed().template is <T>();
+		}
+
+		/**
+		 * @brief Get a view of the items of an array stored packed as T, without copying them.
+		 * @tparam T double, unsigned long long, long long or bool.
+		 * @exception std::bad_variant_access If the value isn't an array packed as T.
+		 */
+		template <typename T>
+		[[nodiscard]] span <const T> get_span() const {
+			return std::get <array_t>(value).packed().template get <T>();
+		}
 		[[nodiscard]] std::size_t index() const;
 		[[nodiscard]] bool isdef() const;
 		[[nodiscard]] bool isndef() const;
 		template <typename T>
 		[[nodiscard]] bool is() const {
-			return std::holds_alternative <T>(value);
+			return std::holds_alternative <stored_t <T>>(value);
 		}
 		const value_t& operator [](const std::size_t& index) const;
-		template <typename T>
+		template <typename T, typename = std::enable_if_t <std::is_convertible_v <const T&, std::string_view>>>
 		const value_t& operator [](const T& index) const {
-			return get <value_map>().at(static_cast <std::string>(index));
+			return get <value_map>().at(static_cast <std::string_view>(index));
+		}
+		/**
+		 * @brief Look for an item of an array without throwing.
+		 * @return The item, nullptr if the value isn't an array or is too short.
+		 */
+		[[nodiscard]] const value_t* find(const std::size_t& index) const;
+		/**
+		 * @brief Look for the value of a key of a map without throwing.
+		 * @return The value, nullptr if the value isn't a map or doesn't have the key.
+		 */
+		[[nodiscard]] const value_t* find(std::string_view key) const;
+
+		/**
+		 * @brief Get a pointer to the underlying value like @ref get gets a reference, without throwing.
+		 * @return nullptr if the value isn't a T.
+		 */
+		template <typename T, typename = std::enable_if_t <convertible_to_ref <T>>>
+		[[nodiscard]] const T* get_if() const {
+			if constexpr (std::is_same_v <T, std::string>) {
+				const istring* res = std::get_if <istring>(&value);
+				return res ? &res->get() : nullptr;
+			}
+			else if constexpr (std::is_same_v <T, value_array> || std::is_same_v <T, value_map>) {
+				const stored_t <T>* res = std::get_if <stored_t <T>>(&value);
+				return res ? &res->get() : nullptr;
+			}
+			else {
+				return std::get_if <T>(&value);
+			}
+		}
+
+		/**
+		 * @brief Check whether @ref operator T() would convert the value to T rather than throw.
+		 */
+		template <typename T>
+		[[nodiscard]] bool can_get() const {
+			static_assert(!is_vector <T> && !is_map <T>, "Only the value itself is checked, not its items.");
+			if constexpr (std::is_same_v <T, std::string> || std::is_same_v <T, std::string_view> ||
+			(std::is_pointer_v <T> && std::is_convertible_v <const char*, T>)) {
+				return value.index() == string;
+			}
+			else if constexpr (std::is_same_v <T, value_array>) {
+				return value.index() == array;
+			}
+			else if constexpr (std::is_same_v <T, value_map>) {
+				return value.index() == map;
+			}
+			else if constexpr (std::is_same_v <T, bool>) {
+				return value.index() == boolean;
+			}
+			else if constexpr (std::is_same_v <T, char>) {
+				return value.index() == character;
+			}
+			else if constexpr (std::is_floating_point_v <T>) {
+				return value.index() == floating;
+			}
+			else if constexpr (std::is_convertible_v <T, int>) {
+				return value.index() == ulonglong || value.index() == longlong;
+			}
+			else {
+				return std::holds_alternative <T>(value);
+			}
+		}
+
+		/**
+		 * @brief Convert self to T like @ref operator T() does, or give back the fallback if it can't be converted.
+		 */
+		template <typename T>
+		[[nodiscard]] T value_or(T fallback) const {
+			if (!can_get <T>()) {
+				return fallback;
+			}
+			if constexpr (convertible_to_class_ref <T>) {
+				return get <T>();
+			}
+			else {
+				return static_cast <T>(*this);
+			}
 		}
 	};
-	struct depth_t {
-		size_t arr_index{NPOS}, map_index{NPOS};
-		index_types index_type{};
-		index_types environment_type{};
-	};
+	static_assert(sizeof(value_t) <= 16, "value_t is meant to fit into 16 bytes.");
 
 	class parse_report {
+		struct text_t {
+			std::string filename;
+			std::string details;
+		};
 		const error_codes error_code{OK};
 		const size_t error_line{};
 		const size_t error_index{};
-		const std::string error_filename;
-		const std::string error_details;
+		// Only allocated if there's something to say, copies share it.
+		const std::shared_ptr <const text_t> text;
 	public:
 		parse_report() = default;
 		parse_report(const error_codes& error_code, std::string_view error_filename);
@@ -253,43 +621,197 @@ namespace henifig {
 		[[nodiscard]] std::string_view get_parse_error_details() const noexcept;
 	};
 	class config_t {
-		struct brace_t {
-			size_t num{}, i{};
-			brace_t(const size_t& num, const size_t& i);
-		};
-		const config_t* cfg_self = this;
+		class builder;
+		struct stream_t;
+		// The private pool and the containers are only made once they're needed,
+		// for making and moving configs not to allocate. A config with variables always has its pool.
+		std::shared_ptr <string_pool> pool;
+		bool private_pool = true;
 		std::string filename;
 		std::vector <std::string> vars;
-		std::map <std::string, size_t> var_nums;
-		std::vector <std::string> values_str;
+		using nums_t = std::map <std::string, size_t, std::less <>>;
+		nums_t var_nums;
 		value_array values;
-		std::vector <value_array> arrs;
-		std::vector <value_map> maps;
-		std::map <std::string, size_t> line_nums;
-		std::stack <size_t> arr_indexes, map_indexes;
-		std::map <size_t, std::string> map_keys;
-		std::stringstream content, parsed_content;
+		struct containers_t {
+			std::deque <array_data> arrs;
+			std::deque <value_map> maps;
+		};
+		std::unique_ptr <containers_t> containers;
+		nums_t line_nums;
+		struct include_t {
+			std::string path;
+			size_t line{};
+			std::shared_ptr <const config_t> cfg;
+		};
+		std::vector <std::string> include_chain;
+		std::vector <include_t> includes;
+		// The canonical paths and content hashes of an included file and of every file it includes, directly or not.
+		std::vector <std::pair <std::string, size_t>> sources;
+		// The parser of the config being fed, until it's finished.
+		std::shared_ptr <stream_t> stream;
+		// What recycle() kept of the previous contents, for the next ones to reuse.
+		std::vector <std::string> spare_vars;
+		std::vector <nums_t::node_type> spare_nums;
+		size_t arrs_used{}, maps_used{};
+		bool track_locations{};
+		parse_options options;
+		// What this config and the files it includes used up of the limits, shared with the including config if there's one.
+		std::shared_ptr <parse_usage> usage;
+		location_table locations;
+		// How many variables were parsed from this config's own text, they come after the included ones.
+		size_t located_vars{};
+		// The buffer given to read_in_place, its escape-free strings are borrowed rather than interned.
+		std::string_view in_place;
+		std::shared_ptr <const void> in_place_owner;
+		string_views borrowed;
+		/**
+		 * @brief Clear the config to be parsed into again, keeping all the memory it holds.
+		 */
+		void recycle();
+		array_data& new_array();
+		value_map& new_map();
+		string_pool& strings();
+		std::string new_var(std::string_view name);
+		void set_num(nums_t& nums, std::string_view name, const size_t& x);
 		parse_report process_parsing();
-		parse_report remove_comments();
-		parse_report lex();
-		parse_report parse();
-		size_t parse_value(const size_t& var_num, const size_t& pos = 0, depth_t depth = {});
-		parse_report append(depth_t& depth, const value_t& value = declaration_t{});
+		parse_report load_includes();
+		parse_report merge_includes();
+		static std::shared_ptr <const config_t> load_include(const std::string& path, const std::vector <std::string>& chain, std::string_view includer, const size_t& line, const parse_options& options, const std::shared_ptr <parse_usage>& usage);
+		/**
+		 * @brief Deep-copy a value owned by any config into the containers and string pool of this one.
+		 */
+		value_t adopt(const value_t& x);
+		friend class overlay_t;
+		friend class snapshot_t;
+		friend class parser;
 		size_t space_offsets{};
 		std::string get_spaces(const size_t& offset = 2) const;
 		error_codes print_array(const value_array& x);
 		error_codes print_map(const value_map& x);
 		std::string value_to_json(const value_t& value, const size_t& spaces);
 		void read(std::string_view new_content);
+		void read(std::streambuf& input);
+		/**
+		 * @brief Parse the next piece of the config, on top of whatever was set up for it already.
+		 */
+		void read_chunk(std::string_view chunk);
+		/**
+		 * @brief Get the parser of the config being read, made anew if it's not begun, ready for the next piece.
+		 */
+		stream_t& open_stream();
 	public:
 		config_t() = default;
+		/**
+		 * @brief Copy the values into containers and a string pool of the copy's own, for it not to depend on the original.
+		 * An unfinished @ref feed isn't copied.
+		 */
+		config_t(const config_t& other);
+		/**
+		 * @brief Take over the contents of a config in constant time. The containers stay where they are,
+		 * so the values got from the other config stay valid and now belong to this one.
+		 */
+		config_t(config_t&& other) noexcept;
+		config_t& operator =(const config_t& other);
+		config_t& operator =(config_t&& other) noexcept;
+		void swap(config_t& other) noexcept;
+		friend void swap(config_t& a, config_t& b) noexcept {
+			a.swap(b);
+		}
 		void clear();
 		explicit config_t(std::string_view filename);
 		void operator <<(std::string_view new_content);
 		void operator <<(const std::ifstream& cfg_file);
 		void open(std::string_view new_filename);
+		/**
+		 * @brief Parse a buffer which stays where it is, e.g. a mapped file, like @ref operator<< does.
+		 * The string values written without escapes are left in the buffer instead of being copied into the string pool,
+		 * so the buffer must outlive the config's contents unless owner keeps it alive, which the config holds on to until it's cleared.
+		 */
+		void read_in_place(std::string_view content, std::shared_ptr <const void> owner = nullptr);
+		/**
+		 * @brief Read a config in pieces as they arrive, e.g. from a pipe or a socket.
+		 * The first piece after a @ref finish, or of a new config, clears the previous contents.
+		 * A piece may end anywhere, only the literal being read is kept until the next one.
+		 * @exception parse_exception As soon as an error is found, after which the config is cleared.
+		 */
+		void feed(std::string_view chunk);
+		/**
+		 * @brief End the config given to @ref feed, reporting whatever was left hanging and loading its includes.
+		 * @exception parse_exception If the config is incomplete or an included file fails to load.
+		 */
+		void finish();
+		/**
+		 * @brief Intern the strings of the next parsed configs into the given pool, e.g. @ref string_pool::global.
+		 */
+		void set_string_pool(std::shared_ptr <string_pool> new_pool);
+		/**
+		 * @return The pool the strings are interned into, nullptr if the config's private one isn't needed yet.
+		 */
+		[[nodiscard]] const std::shared_ptr <string_pool>& get_string_pool() const;
+		/**
+		 * @brief Forget the parsed included files, which are otherwise kept to be shared by every config including them.
+		 */
+		static void clear_include_cache();
+		/**
+		 * @brief Replace the contents with the parsed ones like @ref operator<< does, returning the errors instead of throwing them.
+		 * @return The first error found, after which the config is cleared.
+		 */
+		[[nodiscard]] parse_report try_parse(std::string_view new_content);
+		/**
+		 * @brief Parse like @ref try_parse does, but carry on after an error from the next top-level declaration,
+		 * for every error of a config and its included files to be found in one go.
+		 * @return Every error found, after which the config is cleared. Empty if the config was parsed fine.
+		 */
+		[[nodiscard]] std::vector <parse_report> validate(std::string_view new_content);
 		error_codes print_value(const value_t& x);
 		const value_t& operator [](std::string_view key) const;
+		/**
+		 * @brief Record where every variable, key and item gets written while parsing the next configs, for @ref locate to tell.
+		 */
+		void set_track_locations(const bool& track);
+		/**
+		 * @brief Limit what the next configs read into this one can use up, for configs which can't be trusted.
+		 */
+		void set_options(const parse_options& new_options);
+		[[nodiscard]] const parse_options& get_options() const;
+		/**
+		 * @brief Where the value of a variable was written.
+		 * Unknown if the locations weren't tracked or the variable comes from an included file.
+		 */
+		[[nodiscard]] source_location locate(std::string_view var) const;
+		[[nodiscard]] source_location locate_name(std::string_view var) const;
+		/**
+		 * @brief Where an item of an array of this config was written, or the value of the nth entry of a map.
+		 */
+		[[nodiscard]] source_location locate(const value_t& container, const size_t& item) const;
+		/**
+		 * @brief Where the value of a key of a map of this config was written.
+		 */
+		[[nodiscard]] source_location locate(const value_t& map, std::string_view key) const;
+		[[nodiscard]] source_location locate_key(const value_t& map, std::string_view key) const;
+		/**
+		 * @brief Look for a variable without throwing.
+		 * @return The value of the variable, nullptr if it doesn't exist.
+		 */
+		[[nodiscard]] const value_t* find(std::string_view key) const;
+		/**
+		 * @brief Get a pointer to the value of a variable if it exists and is a T, nullptr otherwise.
+		 */
+		template <typename T>
+		[[nodiscard]] const T* get_if(const std::string_view key) const {
+			const value_t* res = find(key);
+			return res ? res->get_if <T>() : nullptr;
+		}
+		/**
+		 * @brief Get the value of a variable as T, or the fallback if it doesn't exist or can't be converted.
+		 */
+		template <typename T>
+		[[nodiscard]] T value_or(const std::string_view key, T fallback) const {
+			const value_t* res = find(key);
+			return res ? res->value_or(std::move(fallback)) : fallback;
+		}
+		const std::vector <std::string>& get_vars() const;
+		const value_t& get_value(const size_t& index) const;
 		const value_array& get_arr(const size_t& index) const;
 		const value_map& get_map(const size_t& index) const;
 		std::string to_json(const size_t& spaces = 4);
@@ -0,0 +1,139 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+#include "henifig/types.hpp"
+
+namespace henifig::detail {
+	/**
+	 * @brief How @ref static_value and @ref shared_value read their values. Value gives the node() it points at
+	 * and the chars its strings are in, as well as stored_double() and stored_integer() to get a scalar the way it's stored.
+	 */
+	template <typename Value>
+	class value_reader {
+		[[nodiscard]] constexpr const Value& self() const {
+			return static_cast <const Value&>(*this);
+		}
+		[[nodiscard]] constexpr auto type() const {
+			return self().node().type;
+		}
+	public:
+		[[nodiscard]] constexpr size_t index() const {
+			return type();
+		}
+		[[nodiscard]] constexpr bool isdef() const {
+			return type() == declaration;
+		}
+		/**
+		 * @brief The name of the variable or the key of the map entry this value belongs to, empty for array items.
+		 */
+		[[nodiscard]] constexpr std::string_view key() const {
+			return {self().chars + self().node().key_first, static_cast <size_t>(self().node().key_size)};
+		}
+		/**
+		 * @brief How many characters a string has or how many items a container has.
+		 */
+		[[nodiscard]] constexpr size_t size() const {
+			return type() == string || type() == array || type() == map ? static_cast <size_t>(self().node().size) : 0;
+		}
+
+		/**
+		 * @brief Get the value as it's stored, T being one of std::string_view, char, double, unsigned long long, long long and bool.
+		 * @exception std::bad_variant_access If the value isn't a T.
+		 */
+		template <typename T>
+		[[nodiscard]] constexpr T get() const {
+			if (!holds <T>()) {
+				throw std::bad_variant_access();
+			}
+			if constexpr (std::is_same_v <T, std::string_view>) {
+				return {self().chars + self().node().first, static_cast <size_t>(self().node().size)};
+			}
+			else if constexpr (std::is_floating_point_v <T>) {
+				return static_cast <T>(self().stored_double());
+			}
+			else {
+				return static_cast <T>(self().stored_integer());
+			}
+		}
+
+		/**
+		 * @brief Convert the value to T like @ref value_t::operator T() does.
+		 * @exception std::bad_variant_access If it can't be converted to T.
+		 */
+		template <typename T, typename = std::enable_if_t <std::is_arithmetic_v <T> || std::is_same_v <T, std::string_view>>>
+		[[nodiscard]] constexpr operator T() const {
+			if constexpr (std::is_same_v <T, bool> || std::is_same_v <T, char> || std::is_same_v <T, std::string_view>) {
+				return get <T>();
+			}
+			else if constexpr (std::is_floating_point_v <T>) {
+				return static_cast <T>(get <double>());
+			}
+			else if (type() == ulonglong) {
+				return static_cast <T>(get <unsigned long long>());
+			}
+			else {
+				return static_cast <T>(get <long long>());
+			}
+		}
+
+		/**
+		 * @brief Whether the value can be converted to T.
+		 */
+		template <typename T>
+		[[nodiscard]] constexpr bool can_get() const {
+			if constexpr (!std::is_same_v <T, bool> && !std::is_same_v <T, char> && std::is_integral_v <T>) {
+				return type() == ulonglong || type() == longlong;
+			}
+			else {
+				return holds <T>();
+			}
+		}
+
+		template <typename T>
+		[[nodiscard]] constexpr T value_or(const T fallback) const {
+			return can_get <T>() ? static_cast <T>(*this) : fallback;
+		}
+
+		template <typename T>
+		[[nodiscard]] constexpr bool holds() const {
+			if constexpr (std::is_same_v <T, std::string_view>) {
+				return type() == string;
+			}
+			else if constexpr (std::is_same_v <T, char>) {
+				return type() == character;
+			}
+			else if constexpr (std::is_same_v <T, bool>) {
+				return type() == boolean;
+			}
+			else if constexpr (std::is_floating_point_v <T>) {
+				return type() == floating;
+			}
+			else if constexpr (std::is_same_v <T, unsigned long long>) {
+				return type() == ulonglong;
+			}
+			else {
+				static_assert(std::is_same_v <T, long long>, "Only the scalars of value_t can be held.");
+				return type() == longlong;
+			}
+		}
+	};
+}
@@ -0,0 +1,148 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "henifig/batch.hpp"
+#include "henifig/exception.hpp"
+
+namespace {
+	/**
+	 * @brief The documents left to a worker. It takes them from the front, the others steal from the back.
+	 */
+	class work_queue {
+		std::mutex mutex;
+		std::deque <size_t> tasks;
+	public:
+		void push(const size_t& task) {
+			std::lock_guard lock(mutex);
+			tasks.push_back(task);
+		}
+		bool pop(size_t& task) {
+			std::lock_guard lock(mutex);
+			if (tasks.empty()) {
+				return false;
+			}
+			task = tasks.front();
+			tasks.pop_front();
+			return true;
+		}
+		bool steal(size_t& task) {
+			std::lock_guard lock(mutex);
+			if (tasks.empty()) {
+				return false;
+			}
+			task = tasks.back();
+			tasks.pop_back();
+			return true;
+		}
+	};
+
+	template <typename L, typename N>
+	std::vector <henifig::batch_item> run(const size_t& count, const henifig::batch_options& options, const L& load, const N& name) {
+		size_t threads = options.threads ? options.threads : std::max(std::thread::hardware_concurrency(), 1u);
+		threads = std::max <size_t>(std::min(threads, count), 1);
+		// No document is added once they've started, so a worker which can't find one to steal is done.
+		std::vector <work_queue> queues(threads);
+		for (size_t i = 0; i < count; i++) {
+			queues[i % threads].push(i);
+		}
+		std::vector <std::unique_ptr <henifig::config_t>> configs(count);
+		std::vector <std::optional <henifig::parse_report>> reports(count);
+		std::atomic <bool> failed{};
+		std::mutex fatal_mutex;
+		std::exception_ptr fatal;
+		const auto work = [&](const size_t& self) {
+			size_t task{};
+			while (true) {
+				bool found = queues[self].pop(task);
+				for (size_t i = 1; !found && i < threads; i++) {
+					found = queues[(self + i) % threads].steal(task);
+				}
+				if (!found) {
+					return;
+				}
+				if (options.stop_on_error && failed) {
+					reports[task].emplace(henifig::LOAD_CANCELLED, name(task));
+					continue;
+				}
+				try {
+					configs[task] = load(task);
+					reports[task].emplace();
+				}
+				catch (const henifig::parse_exception& e) {
+					reports[task].emplace(e.get_report());
+					failed = true;
+				}
+				catch (...) {
+					// Anything but a parsing error is the caller's to deal with, once every thread is done.
+					std::lock_guard lock(fatal_mutex);
+					if (!fatal) {
+						fatal = std::current_exception();
+					}
+					reports[task].emplace(henifig::LOAD_CANCELLED, name(task));
+					failed = true;
+				}
+			}
+		};
+		std::vector <std::thread> workers;
+		workers.reserve(threads - 1);
+		for (size_t i = 1; i < threads; i++) {
+			workers.emplace_back(work, i);
+		}
+		work(0);
+		for (std::thread& worker : workers) {
+			worker.join();
+		}
+		if (fatal) {
+			std::rethrow_exception(fatal);
+		}
+		std::vector <henifig::batch_item> res;
+		res.reserve(count);
+		for (size_t i = 0; i < count; i++) {
+			res.push_back({std::move(configs[i]), *reports[i]});
+		}
+		return res;
+	}
+}
+
+std::vector <henifig::batch_item> henifig::load_files(const std::vector <std::string>& paths, const batch_options& options) {
+	return run(paths.size(), options, [&paths, &options](const size_t& i) {
+		auto cfg = std::make_unique <config_t>();
+		cfg->set_options(options.parsing);
+		cfg->open(paths[i]);
+		return cfg;
+	}, [&paths](const size_t& i) -> std::string_view {
+		return paths[i];
+	});
+}
+
+std::vector <henifig::batch_item> henifig::load_buffers(const std::vector <std::string_view>& buffers, const batch_options& options) {
+	return run(buffers.size(), options, [&buffers, &options](const size_t& i) {
+		auto cfg = std::make_unique <config_t>();
+		cfg->set_options(options.parsing);
+		*cfg << buffers[i];
+		return cfg;
+	}, [](const size_t&) -> std::string_view {
+		return "";
+	});
+}
@@ -0,0 +1,52 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#include "henifig/bind.hpp"
+
+const char* henifig::detail::type_name(const std::size_t& index) {
+	static const char* names[] = {
+		"unset",
+		"declaration",
+		"string",
+		"character",
+		"double",
+		"unsigned integer",
+		"signed integer",
+		"boolean",
+		"array",
+		"map"
+	};
+	return index < std::size(names) ? names[index] : "unknown";
+}
+
+void henifig::detail::mismatch(bind_errors& errors, const std::string& path, const char* expected, const value_t& value) {
+	errors.push_back({path, std::string("expected ") + expected + ", got " + type_name(value.index())});
+}
+
+henifig::bind_exception::bind_exception(bind_errors errors) : errors(std::move(errors)) {
+	full_error = "Binding error";
+	for (const bind_error& error : this->errors) {
+		full_error += std::string("\n  `") + error.path + "` - " + error.details;
+	}
+}
+
+const henifig::bind_errors& henifig::bind_exception::get_errors() const noexcept {
+	return errors;
+}
+
+const char* henifig::bind_exception::what() const noexcept {
+	return full_error.c_str();
+}
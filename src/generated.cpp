@@ -0,0 +1,94 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <limits>
+
+#include "henifig/generated.hpp"
+
+bool henifig::generated::assign(const scalar_t& x, std::string& out) {
+	if (const auto* str = std::get_if <std::string_view>(&x)) {
+		out.assign(*str);
+		return true;
+	}
+	return x.index() == declaration;
+}
+
+bool henifig::generated::assign(const scalar_t& x, char& out) {
+	if (const auto* c = std::get_if <char>(&x)) {
+		out = *c;
+		return true;
+	}
+	return x.index() == declaration;
+}
+
+bool henifig::generated::assign(const scalar_t& x, double& out) {
+	switch (x.index()) {
+		case floating: {
+			out = std::get <double>(x);
+			return true;
+		}
+		case ulonglong: {
+			out = static_cast <double>(std::get <unsigned long long>(x));
+			return true;
+		}
+		case longlong: {
+			out = static_cast <double>(std::get <long long>(x));
+			return true;
+		}
+		default: {
+			return x.index() == declaration;
+		}
+	}
+}
+
+bool henifig::generated::assign(const scalar_t& x, unsigned long long& out) {
+	if (const auto* ull = std::get_if <unsigned long long>(&x)) {
+		out = *ull;
+		return true;
+	}
+	if (const auto* ll = std::get_if <long long>(&x)) {
+		if (*ll < 0) {
+			return false;
+		}
+		out = static_cast <unsigned long long>(*ll);
+		return true;
+	}
+	return x.index() == declaration;
+}
+
+bool henifig::generated::assign(const scalar_t& x, long long& out) {
+	if (const auto* ll = std::get_if <long long>(&x)) {
+		out = *ll;
+		return true;
+	}
+	if (const auto* ull = std::get_if <unsigned long long>(&x)) {
+		if (*ull > static_cast <unsigned long long>(std::numeric_limits <long long>::max())) {
+			return false;
+		}
+		out = static_cast <long long>(*ull);
+		return true;
+	}
+	return x.index() == declaration;
+}
+
+bool henifig::generated::assign(const scalar_t& x, bool& out) {
+	if (const auto* b = std::get_if <bool>(&x)) {
+		out = *b;
+		return true;
+	}
+	return x.index() == declaration;
+}
@@ -0,0 +1,263 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include "henifig/parser.hpp"
+
+namespace {
+	struct cached_include {
+		size_t hash{};
+		std::shared_ptr <const henifig::config_t> cfg;
+	};
+
+	/**
+	 * @brief Files parsed for @include, shared by every config including them while their content stays the same.
+	 */
+	struct include_cache {
+		std::mutex mutex;
+		std::unordered_map <std::string, cached_include> entries;
+
+		static include_cache& get() {
+			static include_cache cache;
+			return cache;
+		}
+	};
+
+	/**
+	 * @brief One of the threads parsing included files for any config, if there was one to spare.
+	 * Past the limit, the files are parsed on the thread including them.
+	 */
+	class include_thread {
+		inline static std::atomic <size_t> running{};
+		bool reserved{};
+	public:
+		include_thread() {
+			static const size_t limit = std::max(2U, std::thread::hardware_concurrency());
+			size_t count = running.load();
+			while (count < limit && !running.compare_exchange_weak(count, count + 1)) {}
+			reserved = count < limit;
+		}
+		include_thread(include_thread&& other) noexcept : reserved(std::exchange(other.reserved, false)) {}
+		include_thread& operator =(include_thread&&) = delete;
+		~include_thread() {
+			if (reserved) {
+				--running;
+			}
+		}
+		explicit operator bool() const {
+			return reserved;
+		}
+	};
+
+	std::optional <size_t> hash_file(const std::string& path) {
+		std::ifstream file(path);
+		if (!file.is_open()) {
+			return std::nullopt;
+		}
+		return std::hash <std::string>{}((std::stringstream() << file.rdbuf()).str());
+	}
+
+	henifig::value_t item(const henifig::array_t& arr, const size_t& index) {
+		return arr.packed().type() != henifig::unset ? arr.packed().at(index) : arr.get()[index];
+	}
+
+	bool same_value(const henifig::value_t& a, const henifig::value_t& b) {
+		if (a.index() != b.index()) {
+			return false;
+		}
+		switch (a.index()) {
+			case henifig::array: {
+				const henifig::array_t& x = std::get <henifig::array_t>(a.value);
+				const henifig::array_t& y = std::get <henifig::array_t>(b.value);
+				if (x.data == y.data) {
+					return true;
+				}
+				if (x.size() != y.size()) {
+					return false;
+				}
+				for (size_t i = 0; i < x.size(); i++) {
+					if (!same_value(item(x, i), item(y, i))) {
+						return false;
+					}
+				}
+				return true;
+			}
+			case henifig::map: {
+				const henifig::value_map& x = a.get <henifig::value_map>();
+				const henifig::value_map& y = b.get <henifig::value_map>();
+				if (&x == &y) {
+					return true;
+				}
+				if (x.size() != y.size()) {
+					return false;
+				}
+				return std::equal(x.begin(), x.end(), y.begin(), [](const auto& x_item, const auto& y_item) {
+					return x_item.first == y_item.first && same_value(x_item.second, y_item.second);
+				});
+			}
+			default: {
+				return std::visit([&b](const auto& x) {
+					using T = std::decay_t <decltype(x)>;
+					if constexpr (std::is_same_v <T, henifig::unset_t> || std::is_same_v <T, henifig::declaration_t> ||
+					std::is_same_v <T, henifig::array_t> || std::is_same_v <T, henifig::map_t>) {
+						return true;
+					}
+					else {
+						return x == std::get <T>(b.value);
+					}
+				}, a.value);
+			}
+		}
+	}
+}
+
+void henifig::config_t::clear_include_cache() {
+	include_cache& cache = include_cache::get();
+	const std::lock_guard lock(cache.mutex);
+	cache.entries.clear();
+}
+
+std::shared_ptr <const henifig::config_t> henifig::config_t::load_include(const std::string& path, const std::vector <std::string>& chain, const std::string_view includer, const size_t& line, const parse_options& options, const std::shared_ptr <parse_usage>& usage) {
+	const std::string canonical = std::filesystem::weakly_canonical(path).string();
+	std::string details;
+	for (const std::string& x : chain) {
+		details += x + " -> ";
+	}
+	details += canonical;
+	if (std::find(chain.begin(), chain.end(), canonical) != chain.end()) {
+		throw parse_exception(parse_report(INCLUDE_CYCLE, line, 0, includer, details));
+	}
+	std::ifstream file(path);
+	if (!file.is_open()) {
+		throw parse_exception(parse_report(FILE_OPEN_FAILED, line, 0, includer, details));
+	}
+	if (options.is_limited()) {
+		// Read bit by bit so a file too big is given up on before it's all in memory,
+		// and left out of the cache since the configs including it can have other limits.
+		const auto cfg = std::make_shared <config_t>();
+		cfg->filename = path;
+		cfg->include_chain = chain;
+		cfg->include_chain.push_back(canonical);
+		cfg->options = options;
+		cfg->usage = usage;
+		cfg->read(*file.rdbuf());
+		return cfg;
+	}
+	const std::string file_content = (std::stringstream() << file.rdbuf()).str();
+	const size_t hash = std::hash <std::string>{}(file_content);
+	include_cache& cache = include_cache::get();
+	std::shared_ptr <const config_t> cached;
+	{
+		const std::lock_guard lock(cache.mutex);
+		if (const auto found = cache.entries.find(canonical); found != cache.entries.end() && found->second.hash == hash) {
+			cached = found->second.cfg;
+		}
+	}
+	// The file itself is the same, but what it includes could have changed since.
+	if (cached && std::all_of(cached->sources.begin() + 1, cached->sources.end(), [&chain](const auto& source) {
+		return std::find(chain.begin(), chain.end(), source.first) == chain.end() && hash_file(source.first) == source.second;
+	})) {
+		return cached;
+	}
+	// A file being parsed by another thread gets parsed again here rather than waited for,
+	// nothing can deadlock that way.
+	const auto cfg = std::make_shared <config_t>();
+	cfg->filename = path;
+	cfg->include_chain = chain;
+	cfg->include_chain.push_back(canonical);
+	cfg->sources.emplace_back(canonical, hash);
+	cfg->read(file_content);
+	for (const include_t& x : cfg->includes) {
+		cfg->sources.insert(cfg->sources.end(), x.cfg->sources.begin(), x.cfg->sources.end());
+	}
+	const std::lock_guard lock(cache.mutex);
+	cache.entries[canonical] = {hash, cfg};
+	return cfg;
+}
+
+henifig::parse_report henifig::config_t::load_includes() {
+	if (includes.empty()) {
+		return {};
+	}
+	// Every include but the first one is parsed on its own thread while there are threads to spare,
+	// the rest are parsed here once the first one is done.
+	std::vector <std::future <std::shared_ptr <const config_t>>> loading(includes.size());
+	for (size_t i = 1; i < includes.size(); i++) {
+		include_thread thread;
+		if (!thread) {
+			break;
+		}
+		loading[i] = std::async(std::launch::async, [this, &x = includes[i], thread = std::move(thread)]() {
+			return load_include(x.path, include_chain, filename, x.line, options, usage);
+		});
+	}
+	for (size_t i = 0; i < includes.size(); i++) {
+		includes[i].cfg = loading[i].valid() ? loading[i].get() : load_include(includes[i].path, include_chain, filename, includes[i].line, options, usage);
+	}
+	return {};
+}
+
+henifig::parse_report henifig::config_t::merge_includes() {
+	if (includes.empty()) {
+		return {};
+	}
+	std::vector <std::string> merged_vars;
+	std::vector <value_t> merged_values;
+	// Views of the names in the included configs, which outlive this function.
+	std::unordered_map <std::string_view, size_t> merged_nums;
+	for (const include_t& x : includes) {
+		const std::vector <std::string>& included_vars = x.cfg->get_vars();
+		for (size_t i = 0; i < included_vars.size(); i++) {
+			const value_t& value = x.cfg->get_value(i);
+			if (const auto found = var_nums.find(included_vars[i]); found != var_nums.end()) {
+				return {REDECLARED_VAR, x.line, 0, filename, included_vars[i]};
+			}
+			if (line_nums.count(included_vars[i])) {
+				// The same variable with the same value, e.g. from a file included through several others, only counts once.
+				const auto merged = merged_nums.find(included_vars[i]);
+				if (merged != merged_nums.end() && same_value(merged_values[merged->second], value)) {
+					continue;
+				}
+				return {REDECLARED_VAR, x.line, 0, filename, included_vars[i]};
+			}
+			line_nums[included_vars[i]] = x.line;
+			merged_nums.emplace(included_vars[i], merged_vars.size());
+			merged_vars.push_back(included_vars[i]);
+			merged_values.push_back(value);
+		}
+	}
+	merged_vars.insert(merged_vars.end(), vars.begin(), vars.end());
+	merged_values.insert(merged_values.end(), values.begin(), values.end());
+	vars = std::move(merged_vars);
+	values = std::move(merged_values);
+	strings();
+	var_nums.clear();
+	for (size_t i = 0; i < vars.size(); i++) {
+		var_nums[vars[i]] = i;
+	}
+	return {};
+}
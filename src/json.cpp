@@ -85,8 +85,15 @@ std::string henifig::config_t::value_to_json(const value_t& value, const size_t&
 		case array: {
 			std::string array_values;
 			json_value += "[";
-			for (const value_t& x : value.get <value_array>()) {
-				json_value += value_to_json(x, spaces) + ", ";
+			if (const packed_array& packed = std::get <array_t>(value.value).packed(); packed.type() != unset) {
+				for (size_t i = 0; i < packed.size(); i++) {
+					json_value += value_to_json(packed.at(i), spaces) + ", ";
+				}
+			}
+			else {
+				for (const value_t& x : value.get <value_array>()) {
+					json_value += value_to_json(x, spaces) + ", ";
+				}
 			}
 			json_value.pop_back();
 			json_value.back() = ']';
@@ -97,7 +104,7 @@ std::string henifig::config_t::value_to_json(const value_t& value, const size_t&
 			json_value += "{\n";
 			++space_offsets;
 			for (const auto& [key, val] : value.get <value_map>()) {
-				json_value += get_spaces(spaces) + '"' + key + "\" : " + value_to_json(val, spaces) + ",\n";
+				json_value += get_spaces(spaces) + '"' + key.get() + "\" : " + value_to_json(val, spaces) + ",\n";
 			}
 			--space_offsets;
 			json_value.erase(json_value.size() - 2, 2);
@@ -0,0 +1,163 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <algorithm>
+
+#include "henifig/locations.hpp"
+
+namespace {
+	void put_varint(std::vector <uint8_t>& bytes, size_t x) {
+		while (x >= 0x80) {
+			bytes.push_back(static_cast <uint8_t>(x | 0x80));
+			x >>= 7;
+		}
+		bytes.push_back(static_cast <uint8_t>(x));
+	}
+
+	size_t get_varint(const std::vector <uint8_t>& bytes, size_t& offset) {
+		size_t res = 0;
+		for (size_t shift = 0;; shift += 7) {
+			const uint8_t byte = bytes[offset++];
+			res |= static_cast <size_t>(byte & 0x7f) << shift;
+			if (!(byte & 0x80)) {
+				return res;
+			}
+		}
+	}
+}
+
+bool henifig::source_location::is_known() const {
+	return line != 0;
+}
+
+uint32_t henifig::location_table::add_container(const void* address) {
+	const auto res = static_cast <uint32_t>(containers.size() + 1);
+	containers.emplace_back(address, res);
+	return res;
+}
+
+void henifig::location_table::record(const uint32_t& container, const size_t& line, const size_t& index) {
+	recorded.push_back({container, line, index});
+}
+
+void henifig::location_table::finish() {
+	// Group the positions by container, keeping their order: count them, then put each one in its place.
+	const size_t count = containers.size() + 1;
+	std::vector <size_t> firsts(count + 1, 0);
+	for (const entry& x : recorded) {
+		++firsts[x.container + 1];
+	}
+	for (size_t i = 1; i <= count; i++) {
+		firsts[i] += firsts[i - 1];
+	}
+	std::vector <entry> grouped(recorded.size());
+	{
+		std::vector <size_t> next(firsts.begin(), firsts.end() - 1);
+		for (const entry& x : recorded) {
+			grouped[next[x.container]++] = x;
+		}
+	}
+	std::vector <entry>().swap(recorded);
+	bytes.clear();
+	bytes.reserve(grouped.size() * 2);
+	starts.assign(count + 1, 0);
+	checkpoints.clear();
+	checkpoint_starts.assign(count + 1, 0);
+	for (size_t container = 0; container < count; container++) {
+		starts[container] = static_cast <uint32_t>(bytes.size());
+		checkpoint_starts[container] = static_cast <uint32_t>(checkpoints.size());
+		// Positions only go forward: a line is stored as the amount of lines down, the index as the amount of
+		// characters right on the same line or from the beginning of a new one.
+		size_t line = 0, index = 0;
+		for (size_t i = firsts[container]; i < firsts[container + 1]; i++) {
+			if (i != firsts[container] && (i - firsts[container]) % checkpoint_interval == 0) {
+				checkpoints.push_back({static_cast <uint32_t>(bytes.size()), line, index});
+			}
+			put_varint(bytes, grouped[i].line - line);
+			put_varint(bytes, grouped[i].line == line ? grouped[i].index - index : grouped[i].index);
+			line = grouped[i].line;
+			index = grouped[i].index;
+		}
+	}
+	starts[count] = static_cast <uint32_t>(bytes.size());
+	checkpoint_starts[count] = static_cast <uint32_t>(checkpoints.size());
+	bytes.shrink_to_fit();
+	checkpoints.shrink_to_fit();
+	std::sort(containers.begin(), containers.end());
+}
+
+void henifig::location_table::clear() {
+	recorded.clear();
+	bytes.clear();
+	starts.clear();
+	checkpoints.clear();
+	checkpoint_starts.clear();
+	containers.clear();
+}
+
+bool henifig::location_table::empty() const {
+	return starts.empty();
+}
+
+uint32_t henifig::location_table::find(const void* address) const {
+	const auto found = std::lower_bound(containers.begin(), containers.end(), std::pair <const void*, uint32_t>(address, 0));
+	if (found == containers.end() || found->first != address) {
+		return top;
+	}
+	return found->second;
+}
+
+void henifig::location_table::rebase(const std::vector <std::pair <const void*, const void*>>& moved) {
+	for (auto& [address, container] : containers) {
+		const auto found = std::lower_bound(moved.begin(), moved.end(), std::pair <const void*, const void*>(address, nullptr));
+		if (found != moved.end() && found->first == address) {
+			address = found->second;
+		}
+	}
+	std::sort(containers.begin(), containers.end());
+}
+
+henifig::source_location henifig::location_table::get(const uint32_t& container, const size_t& position) const {
+	if (container + 1 >= starts.size()) {
+		return {};
+	}
+	size_t offset = starts[container];
+	const size_t end = starts[container + 1];
+	source_location res;
+	size_t i = 0;
+	// Start from the last checkpoint before the position.
+	if (const size_t passed = std::min <size_t>(position / checkpoint_interval, checkpoint_starts[container + 1] - checkpoint_starts[container])) {
+		const checkpoint& x = checkpoints[checkpoint_starts[container] + passed - 1];
+		offset = x.offset;
+		res = {x.line, x.index};
+		i = passed * checkpoint_interval;
+	}
+	for (; offset < end; i++) {
+		const size_t lines = get_varint(bytes, offset);
+		const size_t index = get_varint(bytes, offset);
+		res.index = lines ? index : res.index + index;
+		res.line += lines;
+		if (i == position) {
+			return res;
+		}
+	}
+	return {};
+}
+
+size_t henifig::location_table::size_in_bytes() const {
+	return bytes.size() + checkpoints.size() * sizeof(checkpoint);
+}
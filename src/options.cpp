@@ -0,0 +1,28 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include "henifig/options.hpp"
+
+bool henifig::parse_options::is_limited() const {
+	return max_input_bytes != unlimited || max_depth != unlimited || max_nodes != unlimited ||
+	max_string_length != unlimited || max_container_size != unlimited || max_vars != unlimited ||
+	cancel || deadline != std::chrono::steady_clock::time_point::max();
+}
+
+bool henifig::parse_options::includes_allowed() const {
+	return allow_includes.value_or(!is_limited());
+}
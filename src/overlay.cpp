@@ -0,0 +1,166 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <unordered_set>
+
+#include "henifig/overlay.hpp"
+#include "henifig/exception.hpp"
+
+void henifig::overlay_node::push(const value_t& x) {
+	layers.push_back(&x);
+}
+
+bool henifig::overlay_node::exists() const {
+	return !layers.empty();
+}
+
+const henifig::value_t& henifig::overlay_node::value() const {
+	if (layers.empty()) {
+		throw retrieval_exception("No layer has a value here.");
+	}
+	return *layers.front();
+}
+
+size_t henifig::overlay_node::index() const {
+	return value().index();
+}
+
+bool henifig::overlay_node::contains(const std::string_view key) const {
+	for (const value_t* x : layers) {
+		if (x->index() != map) {
+			break;
+		}
+		if (x->get <value_map>().contains(key)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+henifig::overlay_node henifig::overlay_node::operator [](const std::string_view key) const {
+	overlay_node res;
+	for (const value_t* x : layers) {
+		if (x->index() != map) {
+			break;
+		}
+		const value_map& items = x->get <value_map>();
+		const auto found = items.find(key);
+		if (found == items.end()) {
+			continue;
+		}
+		res.push(found->second);
+		if (found->second.index() != map) {
+			break;
+		}
+	}
+	return res;
+}
+
+std::vector <henifig::istring> henifig::overlay_node::keys() const {
+	std::vector <istring> res;
+	std::unordered_set <std::string_view> seen;
+	for (auto x = layers.rbegin(); x != layers.rend(); ++x) {
+		if ((*x)->index() != map) {
+			continue;
+		}
+		for (const auto& [key, item] : (*x)->get <value_map>()) {
+			if (seen.insert(key.view()).second) {
+				res.push_back(key);
+			}
+		}
+	}
+	return res;
+}
+
+henifig::overlay_t::overlay_t(const std::initializer_list <std::reference_wrapper <const config_t>> layers) {
+	for (const config_t& x : layers) {
+		push(x);
+	}
+}
+
+henifig::overlay_t& henifig::overlay_t::push(const config_t& layer) {
+	layers.push_back(&layer);
+	return *this;
+}
+
+size_t henifig::overlay_t::size() const {
+	return layers.size();
+}
+
+bool henifig::overlay_t::contains(const std::string_view var) const {
+	for (const config_t* x : layers) {
+		if (x->var_nums.count(var)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+henifig::overlay_node henifig::overlay_t::operator [](const std::string_view var) const {
+	overlay_node res;
+	for (auto x = layers.rbegin(); x != layers.rend(); ++x) {
+		const auto found = (*x)->var_nums.find(var);
+		if (found == (*x)->var_nums.end()) {
+			continue;
+		}
+		const value_t& value = (*x)->values[found->second];
+		res.push(value);
+		if (value.index() != map) {
+			break;
+		}
+	}
+	return res;
+}
+
+std::vector <std::string> henifig::overlay_t::get_vars() const {
+	std::vector <std::string> res;
+	std::unordered_set <std::string_view> seen;
+	for (const config_t* x : layers) {
+		for (const std::string& var : x->vars) {
+			if (seen.insert(var).second) {
+				res.push_back(var);
+			}
+		}
+	}
+	return res;
+}
+
+henifig::value_t henifig::overlay_t::flatten_node(config_t& res, const overlay_node& node) {
+	// A single layer has nothing to merge.
+	if (node.layers.size() == 1) {
+		return res.adopt(node.value());
+	}
+	const std::vector <istring> keys = node.keys();
+	value_map& merged = res.new_map();
+	merged.reserve(keys.size());
+	for (const istring& key : keys) {
+		merged[res.strings().intern(key.view())] = flatten_node(res, node[key.view()]);
+	}
+	return map_t{&merged};
+}
+
+henifig::config_t henifig::overlay_t::flatten() const {
+	config_t res;
+	res.strings();
+	res.vars = get_vars();
+	res.values.reserve(res.vars.size());
+	for (size_t i = 0; i < res.vars.size(); i++) {
+		res.var_nums[res.vars[i]] = i;
+		res.values.push_back(flatten_node(res, (*this)[res.vars[i]]));
+	}
+	return res;
+}
@@ -14,50 +14,597 @@
  * limitations under the License.
 ***************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <filesystem>
+
 #include "henifig/parser.hpp"
+#include "henifig/sax.hpp"
 #include "henifig/internal/logger.hpp"
 #include "henifig/get.hpp"
 
+/**
+ * @brief Builds the values of a config from the events of a sax_parser.
+ */
+class henifig::config_t::builder final : public sax_handler {
+	struct container_t {
+		array_data* arr{};
+		value_map* items{};
+		uint32_t location{};
+	};
+	config_t* cfg;
+	const sax_parser* parser{};
+	std::vector <container_t> containers;
+	istring key;
+	// Leave the containers as big as they got, for the next config to fill them again.
+	bool keep_capacity{};
+
+	void locate(const uint32_t& container) const {
+		if (cfg->track_locations) {
+			cfg->locations.record(container, parser->get_token_line(), parser->get_token_index());
+		}
+	}
+	[[nodiscard]] uint32_t current_location() const {
+		return containers.empty() ? location_table::top : containers.back().location;
+	}
+	[[nodiscard]] uint32_t add_location(const void* container) const {
+		return cfg->track_locations ? cfg->locations.add_container(container) : location_table::top;
+	}
+	void put(const value_t& x) {
+		if (containers.empty()) {
+			cfg->values.push_back(x);
+		}
+		else if (containers.back().arr) {
+			add_item(*containers.back().arr, x);
+		}
+		else {
+			(*containers.back().items)[key] = x;
+		}
+	}
+	template <typename T>
+	static bool pack(array_data& arr, const value_t& x) {
+		if (arr.packed.type() != unset && !arr.packed.is <T>()) {
+			return false;
+		}
+		arr.packed.push_back(std::get <T>(x.value));
+		return true;
+	}
+	/**
+	 * @brief Write the items of an array into contiguous storage while they're all the same kind of literal,
+	 * boxing them into value_t's at the first one which isn't.
+	 */
+	static void add_item(array_data& arr, const value_t& x) {
+		if (arr.items.empty()) {
+			switch (x.index()) {
+				case floating: {
+					if (pack <double>(arr, x)) {
+						return;
+					}
+					break;
+				}
+				case ulonglong: {
+					if (pack <unsigned long long>(arr, x)) {
+						return;
+					}
+					break;
+				}
+				case longlong: {
+					if (pack <long long>(arr, x)) {
+						return;
+					}
+					break;
+				}
+				case boolean: {
+					if (pack <bool>(arr, x)) {
+						return;
+					}
+					break;
+				}
+				default: break;
+			}
+			arr.items.reserve(arr.packed.size() + 1);
+			for (size_t i = 0; i < arr.packed.size(); i++) {
+				arr.items.push_back(arr.packed.at(i));
+			}
+			arr.packed.clear();
+		}
+		arr.items.push_back(x);
+	}
+public:
+	explicit builder(config_t& cfg) : cfg(&cfg) {}
+	/**
+	 * @brief Follow the config if it was moved between two pieces of its input.
+	 */
+	void set_config(config_t& new_cfg) {
+		cfg = &new_cfg;
+	}
+	void set_parser(const sax_parser& new_parser) {
+		parser = &new_parser;
+	}
+	void set_keep_capacity(const bool& keep) {
+		keep_capacity = keep;
+	}
+	error_codes on_var(const std::string_view name) override {
+		if (cfg->var_nums.count(name)) {
+			return REDECLARED_VAR;
+		}
+		cfg->set_num(cfg->var_nums, name, cfg->vars.size());
+		cfg->set_num(cfg->line_nums, name, parser->get_line());
+		cfg->vars.push_back(cfg->new_var(name));
+		cfg->strings();
+		locate(location_table::top);
+		return OK;
+	}
+	error_codes on_key(const std::string_view new_key) override {
+		if (containers.back().items->contains(new_key)) {
+			return REDECLARED_KEY;
+		}
+		key = cfg->strings().intern(new_key);
+		locate(current_location());
+		return OK;
+	}
+	error_codes on_scalar(const scalar_t& x) override {
+		locate(current_location());
+		if (const auto* str = std::get_if <std::string_view>(&x)) {
+			const std::string_view& source = cfg->in_place;
+			if (str->data() >= source.data() && str->data() + str->size() <= source.data() + source.size()) {
+				put(cfg->borrowed.view(*str));
+			}
+			else {
+				put(cfg->strings().intern(*str));
+			}
+		}
+		else {
+			std::visit([this](const auto& y) {
+				if constexpr (!std::is_same_v <std::decay_t <decltype(y)>, std::string_view>) {
+					put(y);
+				}
+			}, x);
+		}
+		return OK;
+	}
+	error_codes on_array_begin() override {
+		array_data& arr = cfg->new_array();
+		locate(current_location());
+		put(array_t{&arr});
+		containers.push_back({&arr, nullptr, add_location(&arr)});
+		return OK;
+	}
+	error_codes on_array_end() override {
+		if (!keep_capacity) {
+			containers.back().arr->packed.shrink_to_fit();
+		}
+		containers.pop_back();
+		return OK;
+	}
+	error_codes on_map_begin() override {
+		value_map& items = cfg->new_map();
+		locate(current_location());
+		put(map_t{&items});
+		containers.push_back({nullptr, &items, add_location(&items)});
+		return OK;
+	}
+	error_codes on_map_end() override {
+		if (!keep_capacity) {
+			containers.back().items->shrink_to_fit();
+		}
+		containers.pop_back();
+		return OK;
+	}
+	error_codes on_include(const std::string_view path) override {
+		if (!cfg->options.includes_allowed()) {
+			return INCLUDE_NOT_ALLOWED;
+		}
+		const std::filesystem::path include_path = path;
+		cfg->includes.push_back({(include_path.is_absolute() ? include_path : std::filesystem::path(cfg->filename).parent_path() / include_path).string(), parser->get_line(), nullptr});
+		return OK;
+	}
+};
+
+struct henifig::config_t::stream_t {
+	builder values_builder;
+	sax_parser parser;
+
+	explicit stream_t(config_t& cfg) : values_builder(cfg), parser(values_builder, cfg.filename) {
+		values_builder.set_parser(parser);
+		parser.set_options(cfg.options);
+	}
+};
+
+henifig::parser::parser(std::shared_ptr <string_pool> pool) : pool(std::move(pool)) {}
+
+void henifig::parser::parse(const std::string_view content, config_t& out) {
+	out.recycle();
+	if (pool_limit && pool->bytes() > pool_limit) {
+		pool = std::make_shared <string_pool>();
+		// The spare configs hold nothing worth keeping, they'd only keep the old pool alive.
+		for (const std::unique_ptr <config_t>& x : free_configs) {
+			x->recycle();
+			x->pool = pool;
+		}
+	}
+	if (out.pool != pool) {
+		out.set_string_pool(pool);
+	}
+	if (!stream) {
+		stream = std::make_shared <config_t::stream_t>(out);
+		stream->values_builder.set_keep_capacity(true);
+	}
+	out.stream = stream;
+	out.read(content);
+}
+
+henifig::parser::config_ptr henifig::parser::parse(const std::string_view content) {
+	config_ptr res(nullptr, recycler(*this));
+	if (free_configs.empty()) {
+		res.reset(new config_t);
+	}
+	else {
+		res.reset(free_configs.back().release());
+		free_configs.pop_back();
+	}
+	parse(content, *res);
+	return res;
+}
+
+const std::shared_ptr <henifig::string_pool>& henifig::parser::get_string_pool() const {
+	return pool;
+}
+
+void henifig::parser::set_pool_limit(const size_t& bytes) {
+	pool_limit = bytes;
+}
+
+void henifig::parser::recycler::operator ()(config_t* cfg) const {
+	owner->free_configs.emplace_back(cfg);
+}
+
+namespace {
+	/**
+	 * @brief Pair the containers of a value with those of its copy, which has the same shape.
+	 */
+	void match_containers(const henifig::value_t& from, const henifig::value_t& to, std::vector <std::pair <const void*, const void*>>& moved) {
+		if (const auto* arr = std::get_if <henifig::array_t>(&from.value)) {
+			const henifig::array_t& copy = std::get <henifig::array_t>(to.value);
+			moved.emplace_back(arr->data, copy.data);
+			if (arr->packed().type() == henifig::unset) {
+				for (size_t i = 0; i < arr->size(); i++) {
+					match_containers(arr->get()[i], copy.get()[i], moved);
+				}
+			}
+		}
+		else if (const auto* items = std::get_if <henifig::map_t>(&from.value)) {
+			const henifig::value_map& copy = std::get <henifig::map_t>(to.value).get();
+			moved.emplace_back(items->items, &copy);
+			auto it = copy.begin();
+			for (const auto& [key, item] : items->get()) {
+				match_containers(item, (it++)->second, moved);
+			}
+		}
+	}
+}
+
+henifig::config_t::config_t(const config_t& other) :
+pool(other.private_pool ? nullptr : other.pool), private_pool(other.private_pool),
+filename(other.filename), vars(other.vars), var_nums(other.var_nums), line_nums(other.line_nums),
+include_chain(other.include_chain), includes(other.includes), sources(other.sources), track_locations(other.track_locations),
+options(other.options), located_vars(other.located_vars), space_offsets(other.space_offsets) {
+	if (!vars.empty()) {
+		strings();
+	}
+	values.reserve(other.values.size());
+	for (const value_t& x : other.values) {
+		values.push_back(adopt(x));
+	}
+	if (other.locations.empty()) {
+		return;
+	}
+	// The copied containers are new ones, the positions recorded for the old ones are moved over to them.
+	std::vector <std::pair <const void*, const void*>> moved;
+	for (size_t i = 0; i < values.size(); i++) {
+		match_containers(other.values[i], values[i], moved);
+	}
+	std::sort(moved.begin(), moved.end());
+	locations = other.locations;
+	locations.rebase(moved);
+}
+
+henifig::config_t::config_t(config_t&& other) noexcept {
+	swap(other);
+}
+
+henifig::config_t& henifig::config_t::operator =(const config_t& other) {
+	if (this != &other) {
+		config_t copy(other);
+		swap(copy);
+	}
+	return *this;
+}
+
+henifig::config_t& henifig::config_t::operator =(config_t&& other) noexcept {
+	config_t moved(std::move(other));
+	swap(moved);
+	return *this;
+}
+
+void henifig::config_t::swap(config_t& other) noexcept {
+	using std::swap;
+	swap(pool, other.pool);
+	swap(private_pool, other.private_pool);
+	swap(filename, other.filename);
+	swap(vars, other.vars);
+	swap(var_nums, other.var_nums);
+	swap(values, other.values);
+	// Swapping the deques swaps their storage, the containers themselves don't move.
+	swap(containers, other.containers);
+	swap(line_nums, other.line_nums);
+	swap(include_chain, other.include_chain);
+	swap(includes, other.includes);
+	swap(sources, other.sources);
+	swap(stream, other.stream);
+	swap(spare_vars, other.spare_vars);
+	swap(spare_nums, other.spare_nums);
+	swap(arrs_used, other.arrs_used);
+	swap(maps_used, other.maps_used);
+	swap(track_locations, other.track_locations);
+	swap(options, other.options);
+	swap(usage, other.usage);
+	swap(locations, other.locations);
+	swap(located_vars, other.located_vars);
+	swap(in_place, other.in_place);
+	swap(in_place_owner, other.in_place_owner);
+	swap(borrowed, other.borrowed);
+	swap(space_offsets, other.space_offsets);
+}
+
 void henifig::config_t::clear() {
+	if (private_pool && pool) {
+		pool->clear();
+	}
 	filename = std::string();
 	vars.clear();
 	var_nums.clear();
-	values_str.clear();
 	values.clear();
-	arrs.clear();
-	maps.clear();
+	containers.reset();
 	line_nums.clear();
-	arr_indexes = std::stack <size_t>();
-	map_indexes = std::stack <size_t>();
-	map_keys.clear();
-	content.clear();
-	content.str(std::string());
-	parsed_content.clear();
-	parsed_content.str(std::string());
+	include_chain.clear();
+	includes.clear();
+	sources.clear();
+	stream.reset();
+	spare_vars.clear();
+	spare_nums.clear();
+	arrs_used = maps_used = 0;
+	locations.clear();
+	located_vars = 0;
+	in_place = {};
+	in_place_owner.reset();
+	borrowed.clear();
+	usage.reset();
+	space_offsets = 0;
+}
+
+void henifig::config_t::recycle() {
+	if (private_pool && pool) {
+		pool->clear();
+	}
+	filename.clear();
+	for (std::string& var : vars) {
+		spare_vars.push_back(std::move(var));
+	}
+	vars.clear();
+	while (!var_nums.empty()) {
+		spare_nums.push_back(var_nums.extract(var_nums.begin()));
+	}
+	while (!line_nums.empty()) {
+		spare_nums.push_back(line_nums.extract(line_nums.begin()));
+	}
+	values.clear();
+	for (size_t i = 0; i < arrs_used; i++) {
+		containers->arrs[i].clear();
+	}
+	for (size_t i = 0; i < maps_used; i++) {
+		containers->maps[i].clear();
+	}
+	arrs_used = maps_used = 0;
+	include_chain.clear();
+	includes.clear();
+	sources.clear();
+	stream.reset();
+	locations.clear();
+	located_vars = 0;
+	in_place = {};
+	in_place_owner.reset();
+	borrowed.clear();
+	usage.reset();
 	space_offsets = 0;
 }
 
+henifig::array_data& henifig::config_t::new_array() {
+	if (!containers) {
+		containers = std::make_unique <containers_t>();
+	}
+	if (arrs_used == containers->arrs.size()) {
+		containers->arrs.emplace_back();
+	}
+	return containers->arrs[arrs_used++];
+}
+
+henifig::value_map& henifig::config_t::new_map() {
+	if (!containers) {
+		containers = std::make_unique <containers_t>();
+	}
+	if (maps_used == containers->maps.size()) {
+		containers->maps.emplace_back();
+	}
+	return containers->maps[maps_used++];
+}
+
+henifig::string_pool& henifig::config_t::strings() {
+	if (!pool) {
+		pool = std::make_shared <string_pool>();
+	}
+	return *pool;
+}
+
+std::string henifig::config_t::new_var(const std::string_view name) {
+	if (spare_vars.empty()) {
+		return std::string(name);
+	}
+	std::string res = std::move(spare_vars.back());
+	spare_vars.pop_back();
+	res.assign(name);
+	return res;
+}
+
+void henifig::config_t::set_num(nums_t& nums, const std::string_view name, const size_t& x) {
+	if (const auto found = nums.find(name); found != nums.end()) {
+		found->second = x;
+		return;
+	}
+	if (spare_nums.empty()) {
+		nums.emplace(name, x);
+		return;
+	}
+	nums_t::node_type node = std::move(spare_nums.back());
+	spare_nums.pop_back();
+	node.key().assign(name);
+	node.mapped() = x;
+	nums.insert(std::move(node));
+}
+
 henifig::config_t::config_t(const std::string_view filename) {
 	this->open(filename);
 }
 
 void henifig::config_t::read(const std::string_view new_content) {
-	content << new_content;
-	if (const parse_report report = process_parsing(); report.is_error()) {
+	this->read_chunk(new_content);
+	this->finish();
+}
+
+void henifig::config_t::read(std::streambuf& input) {
+	std::array <char, 16384> buffer{};
+	for (std::streamsize size; (size = input.sgetn(buffer.data(), buffer.size())) > 0;) {
+		this->read_chunk({buffer.data(), static_cast <size_t>(size)});
+	}
+	this->finish();
+}
+
+void henifig::config_t::feed(const std::string_view chunk) {
+	// The first piece of a new config replaces what was read before, like operator<< does.
+	if (!stream) {
+		this->clear();
+	}
+	this->read_chunk(chunk);
+}
+
+henifig::config_t::stream_t& henifig::config_t::open_stream() {
+	if (!stream) {
+		stream = std::make_shared <stream_t>(*this);
+	}
+	stream->values_builder.set_config(*this);
+	// A parser's stream is shared by many configs, each with its own limits.
+	stream->parser.set_options(options);
+	// The included files are charged to the same usage, which they're given before being read.
+	if (options.is_limited() && !usage) {
+		usage = std::make_shared <parse_usage>();
+	}
+	stream->parser.set_usage(usage.get());
+	return *stream;
+}
+
+void henifig::config_t::read_chunk(const std::string_view chunk) {
+	if (!open_stream().parser.feed(chunk)) {
+		const parse_report report = stream->parser.finish();
 		this->clear();
 		throw parse_exception(report);
 	}
 }
 
+henifig::parse_report henifig::config_t::try_parse(const std::string_view new_content) {
+	this->clear();
+	// The parser stops at its first error and keeps it for process_parsing to return.
+	open_stream().parser.feed(new_content);
+	const parse_report report = [this]() -> parse_report {
+		try {
+			return process_parsing();
+		}
+		catch (const parse_exception& e) {
+			// Only included files throw.
+			return e.get_report();
+		}
+	}();
+	if (report.is_error()) {
+		this->clear();
+	}
+	return report;
+}
+
+std::vector <henifig::parse_report> henifig::config_t::validate(const std::string_view new_content) {
+	this->clear();
+	open_stream().parser.set_recovery(true);
+	stream->parser.feed(new_content);
+	(void)stream->parser.finish();
+	std::vector <parse_report> res = stream->parser.get_errors();
+	stream.reset();
+	// Each included file gets loaded even if another one fails, to report them all.
+	for (include_t& x : includes) {
+		try {
+			x.cfg = load_include(x.path, include_chain, filename, x.line, options, usage);
+		}
+		catch (const parse_exception& e) {
+			res.push_back(e.get_report());
+		}
+	}
+	if (res.empty()) {
+		if (const parse_report report = merge_includes(); report.is_error()) {
+			res.push_back(report);
+		}
+	}
+	if (!res.empty()) {
+		this->clear();
+	}
+	return res;
+}
+
+void henifig::config_t::finish() {
+	try {
+		if (const parse_report report = process_parsing(); report.is_error()) {
+			throw parse_exception(report);
+		}
+	}
+	catch (...) {
+		// Included files report their own errors.
+		this->clear();
+		throw;
+	}
+}
+
 void henifig::config_t::operator <<(const std::string_view new_content) {
 	this->clear();
 	this->read(new_content);
 }
 
 void henifig::config_t::operator <<(const std::ifstream& cfg_file) {
-	std::stringstream new_content;
-	new_content << cfg_file.rdbuf() << '\n';
-	*this << new_content.str();
+	this->clear();
+	this->read(*cfg_file.rdbuf());
+}
+
+void henifig::config_t::read_in_place(const std::string_view content, std::shared_ptr <const void> owner) {
+	this->clear();
+	in_place = content;
+	in_place_owner = std::move(owner);
+	this->read(content);
+	// Whatever's fed later is interned as usual.
+	in_place = {};
+}
+
+void henifig::config_t::set_string_pool(std::shared_ptr <string_pool> new_pool) {
+	pool = std::move(new_pool);
+	private_pool = false;
+}
+
+const std::shared_ptr <henifig::string_pool>& henifig::config_t::get_string_pool() const {
+	return pool;
 }
 
 void henifig::config_t::open(const std::string_view new_filename) {
@@ -67,769 +614,35 @@ void henifig::config_t::open(const std::string_view new_filename) {
 		throw parse_exception(parse_report(FILE_OPEN_FAILED, new_filename));
 	}
 	filename = new_filename;
-	std::stringstream new_content = std::stringstream() << cfg_file.rdbuf();
-	this->read(new_content.str());
+	include_chain.push_back(std::filesystem::weakly_canonical(filename).string());
+	this->read(*cfg_file.rdbuf());
 }
 
 henifig::parse_report henifig::config_t::process_parsing() {
-	if (const parse_report report = remove_comments(); report.is_error()) {
+	const parse_report report = open_stream().parser.finish();
+	stream.reset();
+	if (report.is_error()) {
 		return report;
 	}
-	if (const parse_report report = lex(); report.is_error()) {
-		return report;
+	if (track_locations) {
+		locations.finish();
+		located_vars = vars.size();
 	}
-	if (const parse_report report = parse(); report.is_error()) {
+	if (const parse_report report = load_includes(); report.is_error()) {
 		return report;
 	}
-	return {};
-}
-
-henifig::parse_report henifig::config_t::remove_comments() {
-	error_codes error_code{};
-	std::string line;
-	size_t hanging_var{}, hanging_comment{}, hanging_escape{}, hanging_quote{}, hanging_apostrophe{}, hanging_arrs{}, hanging_maps{};
-	size_t hanging_comment_line{}, hanging_quote_line{}, hanging_apostrophe_line{};
-
-	std::string buffer;
-
-	size_t line_num{};
-	size_t i{};
-
-	while (std::getline(content, line)) {
-		line = ' ' + line + ' ';
-		++line_num;
-		const size_t first_index = line.find_first_not_of(' ');
-		// We'll start from the first position of whatever could be important.
-		for (i = first_index; i < line.size(); i++) {
-			if (line[i] == ' ' && hanging_escape) {
-				error_code = HANGING_ESCAPE;
-				break;
-			}
-			if (line[i] == '/' && !hanging_var && !hanging_comment && !hanging_quote && !hanging_apostrophe) {
-				hanging_var = i;
-			}
-			if (line[i] == '\\') {
-				if (!hanging_comment && line[i + 1] != '|' && line[i + 1] != ' ') {
-					hanging_escape = !hanging_escape ? i : 0;
-				}
-				if (hanging_var && !hanging_escape && !hanging_comment && !hanging_quote && !hanging_apostrophe) {
-					hanging_var = 0;
-				}
-			}
-			if (line[i] == '#' && (!hanging_var || hanging_arrs || hanging_maps) && !hanging_quote && !hanging_apostrophe) {
-				bool ml_comment_begin{};
-				// Is this the beginning of a multi-line comment?
-
-				if (i != first_index && line[i - 1] == '[' && !hanging_comment) {
-					// We're beginning to read a multi-line comment.
-					hanging_comment = i;
-					hanging_comment_line = line_num;
-					ml_comment_begin = true;
-					line[i - 1] = ' ';
-					line[i] = ' ';
-				}
-				if (i < line.size() - 1 && line[i + 1] == ']') {
-					// This is the end of the currently hanging comment.
-					if (ml_comment_begin) {
-						// This is the end of the comment that was started with the same '#'.
-						error_code = IMPROPERLY_CLOSED_COMMENT;
-						break;
-					}
-					if (!hanging_comment) {
-						error_code = NO_OPENED_COMMENT;
-						break;
-					}
-					hanging_comment = 0;
-					line[i] = ' ';
-					line[i + 1] = ' ';
-				}
-				else if (!hanging_comment) {
-					// We're in a single-line comment.
-					line = line.replace(i, line.size() - i, "");
-					break;
-				}
-			}
-			if (!hanging_comment) {
-				if (!hanging_apostrophe && line[i] == '"' && !hanging_escape) {
-					hanging_quote = !hanging_quote ? i : 0;
-					hanging_quote_line = hanging_quote ? line_num : 0;
-				}
-				else if (!hanging_quote && line[i] == '\'' && !hanging_escape) {
-					hanging_apostrophe = !hanging_apostrophe ? i : 0;
-					hanging_apostrophe_line = hanging_apostrophe ? line_num : 0;
-				}
-				else if (!hanging_quote && !hanging_apostrophe) {
-					if (line[i] == '[') {
-						++hanging_arrs;
-					}
-					else if (line[i] == '{') {
-						++hanging_maps;
-					}
-					else if (line[i] == ']') {
-						--hanging_arrs;
-					}
-					else if (line[i] == '}') {
-						--hanging_maps;
-					}
-				}
-			}
-			else {
-				line[i] = ' ';
-			}
-			if (hanging_escape != i) {
-				hanging_escape = 0;
-			}
-			if (line[i] == '\t') {
-				if (!hanging_quote && !hanging_apostrophe) {
-					line[i] = ' ';
-				}
-			}
-		}
-		if (std::count(line.begin(), line.end(), ' ') == line.size()) {
-			line.clear();
-		}
-		buffer += line;
-		buffer += '\n';
-		if (!line.empty()) {
-			if (!hanging_comment || hanging_comment != first_index) {
-				parsed_content << buffer;
-				buffer.clear();
-			}
-		}
-		if (error_code != OK) {
-			break;
-		}
-		if (hanging_quote) {
-			error_code = HANGING_QUOTE;
-			line_num = hanging_quote_line;
-			i = hanging_quote;
-		}
-		else if (hanging_apostrophe) {
-			error_code = HANGING_APOSTROPHE;
-			line_num = hanging_apostrophe_line;
-			i = hanging_apostrophe;
-		}
-		else if (hanging_escape) {
-			error_code = HANGING_ESCAPE;
-			i = hanging_escape;
-		}
-		if (error_code != OK) {
-			break;
-		}
-	}
-	if (hanging_var) {
-		error_code = HANGING_VAR;
-		i = hanging_var;
-	}
-	else if (hanging_comment) {
-		error_code = HANGING_COMMENT;
-		line_num = hanging_comment_line;
-		i = hanging_comment;
+	if (const parse_report report = merge_includes(); report.is_error()) {
+		return report;
 	}
-	cout << "---\n" << parsed_content.str() << "---\n";
-	return {error_code, line_num, i, filename};
-}
-
-henifig::parse_report henifig::config_t::lex() {
-	std::string line;
-	size_t hanging_var{}, hanging_quote{}, hanging_apostrophe{}, hanging_escape{};
-	size_t braces{};
-	std::stack <brace_t> hanging_arr, hanging_map;
-	std::stack <size_t> hanging_arr_line{}, hanging_map_line{};
-	bool is_double{};
-	size_t hanging_comma_line{};
-	std::string value, value_str;
-	bool var_declared{};
-	bool piped{}, afterpipe{};
-	size_t map_keys_amount{}, map_pipes_amount{};
-	error_codes error_code{};
-
-	size_t i;
-	size_t line_num{};
-	auto unexpected_expression = [&var_declared, &piped, &hanging_var, &hanging_quote,
-	&line, &value, &hanging_apostrophe, &hanging_arr, &hanging_map, &i, &line_num]() -> bool {
-		if ((var_declared && !piped) || (!var_declared && !hanging_var) ||
-		(!hanging_var && !value.empty() &&
-		!hanging_quote && !hanging_apostrophe && hanging_arr.empty() && hanging_map.empty()) &&
-
-		(line[i] >= '0' && line[i] <= '9' &&
-		line[i - 1] < '0' && line[i - 1] > '9' &&
-		line[i - 1] != '.' && (line[i - 1] != '-' || (line[i - 1] == '-' && value.size() > 1))) ||
-		(line[i] < '0' && line[i] > '9') // for some fucking reason replacing this with !isdigit(line[i]) breaks it
-		) {
-			return true;
-		}
-		return false;
-	};
-	auto is_arr = [&hanging_arr, &hanging_map]() -> bool {
-		return !hanging_arr.empty() && (hanging_map.empty() || hanging_arr.top().num > hanging_map.top().num);
-	};
-	auto is_map = [&hanging_arr, &hanging_map]() -> bool {
-		return !hanging_map.empty() && (hanging_arr.empty() || hanging_map.top().num > hanging_arr.top().num);
-	};
-	auto brace_append = [&braces, &i](std::stack <brace_t>& hanging_cont) {
-		hanging_cont.emplace(braces, i);
-		++braces;
-	};
-	auto brace_remove = [&braces](std::stack <brace_t>& hanging_cont) {
-		hanging_cont.pop();
-		--braces;
-	};
-	auto line_num_exists = [&value, &line_num, this, &error_code, &i]() -> bool {
-		size_t& num = line_nums[value];
-		if (num) {
-			i -= value.size() + 1;
-			error_code = REDECLARED_VAR;
-			return true;
+	if (process_logger::is_enabled()) {
+		// Printing boxes the packed arrays, so it's only done when someone's going to read it.
+		cout << "-------\n";
+		for (const value_t& x : values) {
+			print_value(x);
 		}
-		num = line_num;
-		var_nums[value] = vars.size() - 1;
-		return false;
-	};
-	while (std::getline(parsed_content, line)) {
-		++line_num;
-		const size_t first_index = line.find_first_not_of(' ');
-		for (i = first_index; i < line.size(); i++) {
-			if (line[i] != ';' && line[i] != ' ' && line[i] != '/' && line[i] != '|') {
-				if (unexpected_expression()) {
-					error_code = UNEXPECTED_EXPRESSION;
-					break;
-				}
-			}
-			if (line[i] == '\\') {
-				if (!hanging_var && !hanging_quote && !hanging_apostrophe) {
-					error_code = UNEXPECTED_ESCAPE;
-				}
-				if (hanging_var) {
-					if (!hanging_escape) {
-						if (!hanging_quote && !hanging_apostrophe) {
-							if ((i != line.size() - 1 && line[i + 1] == '|' || line[i + 1] == ' ') ||
-							(i != first_index && line[i - 1] == ']' || line[i - 1] == '}') ||
-							i == line.size() - 1) {
-								// If this backslash is to complete a declaration
-								hanging_var = 0;
-								if (!afterpipe) {
-									vars.push_back(value);
-									if (line_num_exists()) {
-										break;
-									}
-									var_declared = true;
-								}
-								else {
-									// This is a /var()\-like declaration
-									if (!hanging_arr.empty()) {
-										error_code = HANGING_ARR;
-										line_num = hanging_arr_line.top();
-										i = hanging_arr.top().i;
-										break;
-									}
-									if (!hanging_map.empty()) {
-										error_code = HANGING_MAP;
-										line_num = hanging_map_line.top();
-										i = hanging_map.top().i;
-										break;
-									}
-									values_str.push_back(value);
-								}
-								value.clear();
-								value_str.clear();
-								is_double = false;
-							}
-						}
-					}
-				}
-				if (hanging_escape) {
-					value += '\\';
-					if (!(hanging_var && !afterpipe)) {
-						value += '\\';
-					}
-					if (hanging_apostrophe) {
-						value_str += '\\';
-					}
-					hanging_escape = 0;
-				}
-				else if ((hanging_var && !afterpipe) || (hanging_quote || hanging_apostrophe)) {
-					hanging_escape = i;
-				}
-			}
-			else if (line[i] == '/') {
-				if (!hanging_quote && !hanging_apostrophe) {
-					if (afterpipe && i != first_index) {
-						error_code = MISSING_SEMICOLON;
-						break;
-					}
-					if (!afterpipe && piped) {
-						error_code = HANGING_PIPE;
-						break;
-					}
-					if (vars.size() > values_str.size()) {
-						values_str.push_back(value);
-					}
-					value.clear();
-					value_str.clear();
-					hanging_var = i;
-					var_declared = false;
-					piped = false;
-					afterpipe = false;
-					is_double = false;
-				}
-				else {
-					value += '/';
-					if (hanging_apostrophe) {
-						value_str += '/';
-					}
-				}
-			}
-			else if (line[i] == '|') {
-				if (is_map()) {
-					value += '|';
-					++map_pipes_amount;
-					if (map_keys_amount != map_pipes_amount) {
-						error_code = PIPED_VALUE;
-						break;
-					}
-				}
-				else if (!afterpipe && !hanging_var) {
-					if (!piped) {
-						piped = true;
-						value.clear();
-						value_str.clear();
-						is_double = false;
-					}
-					else {
-						error_code = HANGING_PIPE;
-						break;
-					}
-				}
-			}
-			else if (line[i] == '\"' || line[i] == '\'' ||
-			line[i] == '[' || line[i] == ']' || line[i] == '{' || line[i] == '}' || line[i] == ',' || line[i] == '$' ||
-			((line[i] >= '0' && line[i] <= '9') || line[i] == '.') || (line[i] == 't' || line[i] == 'f') ||
-			line[i] == ' ' || line[i] == '-' || line[i] == '.') {
-				if (line[i] != ' ' && afterpipe) {
-					const bool is_string = hanging_quote || hanging_apostrophe;
-					bool quote_after_expr{};
-					bool num_after_expr{};
-					bool expr_after_num{};
-					bool expr_after_expr{};
-					bool in_arr{};
-					bool comma_in_begin{};
-					bool comma_in_end{};
-					bool comma_around_pipe{};
-					bool middle_minus{};
-					const bool escaped_num = (isdigit(line[i]) || line[i] == '.' || line[i] == '-') && hanging_escape;
-					bool hanging_dot{};
-					bool hanging_dollar{};
-					bool unexpected_dollar{};
-					bool repeated_dollar{};
-					bool expected_dollar{};
-					bool piped_key{};
-					bool piped_value{};
-					if (!hanging_escape) {
-						quote_after_expr = !value.empty() && line[i] == '"' && *value.rbegin() != '"' && *value.rbegin() != ',' && *value.rbegin() != '[' && *value.rbegin() != '{' && *value.rbegin() != '|' && (line[i - 1] != '$' || line[i - 1] == '$' && !is_map()) && !hanging_quote;
-						num_after_expr =   isdigit(line[i]) && !isdigit(*value.rbegin()) && *value.rbegin() != ',' && *value.rbegin() != '[' && *value.rbegin() != '{' && *value.rbegin() != '-' && *value.rbegin() != '.' && *value.rbegin() != '|';
-						expr_after_num =  !isdigit(line[i]) &&  isdigit(*value.rbegin()) && line[i] != ',' && line[i] != '-' && line[i] != '.' && line[i] != ']' && line[i] != '}';
-						expr_after_expr = !isdigit(line[i]) && line[i] != '"' && line[i] != ']' && line[i] != '}' && line[i] != ',' && line[i] != '-' && line[i] != '.' && *value.rbegin() != ',' && *value.rbegin() != '[' && *value.rbegin() != '{' && *value.rbegin() != '|';
-						in_arr = !hanging_arr.empty() || !hanging_map.empty();
-						comma_in_begin = line[i] == ',' && (*value.rbegin() == '[' || *value.rbegin() == '{');
-						comma_in_end = line[i] == ',' && (*value.rbegin() == '[' || *value.rbegin() == '{');
-						comma_around_pipe = line[i] == ',' && (var_declared && !piped) || (piped && value.empty());
-						middle_minus = line[i] == '-' && line[i - 1] == '-';
-						hanging_dot = line[i] == '.' && !isdigit(line[i + 1]);
-						hanging_dollar = line[i] == '$' && line[i + 1] != '"';
-						unexpected_dollar = line[i] == '$' && !is_map();
-						repeated_dollar = line[i] == '$' && line[i - 1] == '$';
-						expected_dollar = (line[i] != '$' && line[i] != '"') && line[i - 1] != '$' && line[i] != ',' && line[i] != '}' && (value.empty() || !value.empty() && *value.rbegin() != '|' && !isdigit(*value.rbegin()) && *value.rbegin() != '.') && is_map();
-						piped_key = line[i] == '$' && (!value.empty() && *value.rbegin() != '$' && *value.rbegin() != '{' && *value.rbegin() != ',');
-					}
-					// I didn't say I had a lot of tests
-					if (!is_string && ((quote_after_expr ||
-					line[i] != '"' && (!value.empty() &&
-					((num_after_expr || expr_after_num || expr_after_expr) ||
-					(in_arr && comma_in_begin || comma_in_end))
-					) || comma_around_pipe) ||
-					middle_minus || escaped_num || hanging_dot ||
-					hanging_dollar || unexpected_dollar || repeated_dollar || expected_dollar || piped_key || piped_value)) {
-						if (quote_after_expr || num_after_expr || expr_after_num || expr_after_expr) {
-							error_code = UNEXPECTED_EXPRESSION;
-						}
-						else if (comma_in_begin || comma_in_end || comma_around_pipe) {
-							error_code = UNEXPECTED_COMMA;
-						}
-						else if (middle_minus) {
-							error_code = MINUS_IN_MIDDLE;
-						}
-						else if (escaped_num) {
-							error_code = UNDEFINED_ESCAPE;
-						}
-						else if (hanging_dot) {
-							error_code = HANGING_DOT;
-						}
-						else if (hanging_dollar) {
-							error_code = HANGING_DOLLAR;
-						}
-						else if (unexpected_dollar) {
-							error_code = UNEXPECTED_DOLLAR;
-						}
-						else if (repeated_dollar) {
-							error_code = REPEATED_DOLLAR;
-						}
-						else if (expected_dollar) {
-							error_code = EXPECTED_DOLLAR;
-						}
-						else if (piped_key) {
-							error_code = PIPED_KEY;
-						}
-						else {
-							error_code = WRONG_EXPRESSION;
-						}
-						break;
-					}
-				}
-				if (line[i] == '"') {
-					if (!hanging_escape && !hanging_apostrophe) {
-						hanging_quote = !hanging_quote ? i : 0;
-					}
-					else if (hanging_escape) {
-						if (piped) {
-							value += '\\';
-						}
-						if (hanging_apostrophe) {
-							value_str += '"';
-						}
-					}
-					value += '"';
-				}
-				else if (line[i] == '\'') {
-					if (!hanging_escape && !hanging_quote) {
-						if (!hanging_apostrophe) {
-							hanging_apostrophe = i;
-						}
-						else if (value_str.size() > 1) {
-							error_code = MULTIPLE_CHARS;
-							break;
-						}
-						else if (value_str.empty()) {
-							error_code = NO_CHARS;
-							break;
-						}
-						else {
-							value_str.clear();
-							hanging_apostrophe = 0;
-						}
-					}
-					else {
-						if (hanging_escape) {
-							if (afterpipe) {
-								value += '\\';
-							}
-						}
-						if (hanging_apostrophe) {
-							value_str += '\'';
-						}
-					}
-					value += '\'';
-				}
-				else if (line[i] == '[' || line[i] == ']' || line[i] == '{' || line[i] == '}') {
-					if (line[i] == '[' || line[i] == '{') {
-						if ((piped || afterpipe) && hanging_arr.empty() && hanging_map.empty()) {
-							if (line[i] == '[') {
-								error_code = UNEXPECTED_ARR;
-							}
-							else {
-								error_code = UNEXPECTED_MAP;
-							}
-							break;
-						}
-						if (!piped && !hanging_escape && !hanging_quote && !hanging_apostrophe && hanging_arr.empty() && hanging_map.empty()) {
-							var_declared = true;
-							piped = true;
-							vars.push_back(value);
-							if (line_num_exists()) {
-								break;
-							}
-							value.clear();
-							value_str.clear();
-							is_double = false;
-						}
-					}
-					if (line[i] == '[') {
-						if (hanging_quote || hanging_apostrophe) {
-							if (hanging_apostrophe) {
-								value_str += '[';
-							}
-						}
-						else if (!hanging_escape) {
-							brace_append(hanging_arr);
-							hanging_arr_line.push(line_num);
-						}
-						else {
-							if (afterpipe) {
-								value += '\\';
-							}
-						}
-						value += '[';
-					}
-					else if (line[i] == ']') {
-						if (hanging_quote || hanging_apostrophe) {
-							if (hanging_apostrophe) {
-								value_str += ']';
-							}
-						}
-						else if (!hanging_escape) {
-							if (hanging_arr.empty()) {
-								error_code = UNEXPECTED_ARR_END;
-								break;
-							}
-							if (!hanging_map.empty() && hanging_map.top().num > hanging_arr.top().num) {
-								error_code = MAP_COMPLETED_WITH_ARR;
-								break;
-							}
-							if (*value.rbegin() == ',') {
-								error_code = HANGING_COMMA;
-								break;
-							}
-							brace_remove(hanging_arr);
-							hanging_arr_line.pop();
-						}
-						value += ']';
-					}
-					else if (line[i] == '{') {
-						if (hanging_quote || hanging_apostrophe) {
-							if (hanging_apostrophe) {
-								value_str += '{';
-							}
-						}
-						else if (!hanging_escape) {
-							brace_append(hanging_map);
-							hanging_map_line.push(line_num);
-						}
-						else {
-							if (afterpipe) {
-								value += '\\';
-							}
-						}
-						value += '{';
-					}
-					else if (line[i] == '}') {
-						if (hanging_quote || hanging_apostrophe) {
-							if (hanging_apostrophe) {
-								value_str += '}';
-							}
-						}
-						else if (!hanging_escape) {
-							if (map_pipes_amount > hanging_map.size()) {
-								error_code = HANGING_PIPE;
-								break;
-							}
-							if (map_pipes_amount > 0) {
-								--map_pipes_amount;
-							}
-							--map_keys_amount;
-							if (hanging_map.empty()) {
-								error_code = UNEXPECTED_MAP_END;
-								break;
-							}
-							if (!hanging_arr.empty() && hanging_arr.top().num > hanging_map.top().num) {
-								error_code = MAP_COMPLETED_WITH_ARR;
-								break;
-							}
-							if (*value.rbegin() == ',') {
-								error_code = HANGING_COMMA;
-								break;
-							}
-							brace_remove(hanging_map);
-							hanging_map_line.pop();
-						}
-						value += '}';
-					}
-				}
-				else if (line[i] == ',') {
-					if (!hanging_quote && !hanging_apostrophe) {
-						if (hanging_arr.empty() && hanging_map.empty()) {
-							error_code = UNEXPECTED_COMMA;
-							break;
-						}
-						if (value.size() > 1 && *value.rbegin() == ',') {
-							error_code = EXPECTED_EXPRESSION;
-							break;
-						}
-						if (is_map()) {
-							if (map_pipes_amount >= map_keys_amount) {
-								--map_pipes_amount;
-							}
-							--map_keys_amount;
-						}
-					}
-					value += ',';
-				}
-				else if (line[i] == 't') {
-					if (i <= line.size() - 4 - 1 && line.find("true", i) != std::string::npos) {
-						value += "true";
-						if (hanging_apostrophe) {
-							value_str += "true";
-						}
-						i += 4 - 1;
-					}
-					else if ((!hanging_var || (!hanging_arr.empty() || !hanging_map.empty())) && !hanging_quote && !hanging_apostrophe) {
-						if (!hanging_arr.empty() || !hanging_map.empty()) {
-							error_code = UNEXPECTED_EXPRESSION;
-							break;
-						}
-					}
-					else {
-						value += 't';
-						if (hanging_apostrophe) {
-							value_str += 't';
-						}
-					}
-				}
-				else if (line[i] == 'f') {
-					if (i <= line.size() - 5 - 1 && line.find("false", i) == i) {
-						value += "false";
-						if (hanging_apostrophe) {
-							value_str += "false";
-						}
-						i += 5 - 1;
-					}
-					else if ((!hanging_var || (!hanging_arr.empty() || !hanging_map.empty())) && !hanging_quote && !hanging_apostrophe) {
-						if (!hanging_arr.empty() || !hanging_map.empty()) {
-							error_code = UNKNOWN_EXPRESSION;
-							break;
-						}
-					}
-					else {
-						value += 'f';
-						if (hanging_apostrophe) {
-							value_str += 'f';
-						}
-					}
-				}
-				else if (line[i] == '.') {
-					if (is_double) {
-						error_code = REPEATED_DOT;
-						break;
-					}
-					if (!hanging_quote && !hanging_apostrophe) {
-						is_double = true;
-						if (!isdigit(*value.rbegin())) {
-							value += '0';
-						}
-					}
-					value += '.';
-				}
-				else if (line[i] == ' ') {
-					if (hanging_escape) {
-						error_code = HANGING_ESCAPE;
-						break;
-					}
-					if ((hanging_var && !var_declared) || (hanging_quote || hanging_apostrophe)) {
-						value += ' ';
-						if (hanging_apostrophe) {
-							value_str += ' ';
-						}
-					}
-				}
-				else if (line[i] == '$') {
-					if (hanging_quote || hanging_apostrophe) {
-						value += '$';
-						if (hanging_apostrophe) {
-							value_str += '$';
-						}
-					}
-					else if (is_map()) {
-						++map_keys_amount;
-					}
-				}
-				else {
-					value += line[i];
-				}
-				if (piped && line[i] != ' ' && !afterpipe) {
-					afterpipe = true;
-				}
-			}
-			else if (line[i] != ';' && (!hanging_var || (!hanging_arr.empty() || !hanging_map.empty())) && !hanging_quote && !hanging_apostrophe) {
-				error_code = UNKNOWN_EXPRESSION;
-				break;
-			}
-			else if (line[i] != ';') {
-				char to_add;
-				if (hanging_escape) {
-					if (line[i] == 'n') {
-						to_add = '\n';
-					}
-					else if (line[i] == ' ') {
-						error_code = HANGING_ESCAPE;
-						break;
-					}
-					else {
-						error_code = UNDEFINED_ESCAPE;
-						break;
-					}
-				}
-				else {
-					to_add = line[i];
-				}
-				value += to_add;
-				if (hanging_apostrophe) {
-					value_str += to_add;
-				}
-			}
-			if (line[i] == ';') {
-				if (!hanging_quote && !hanging_apostrophe && !hanging_var) {
-					if (piped && !afterpipe) {
-						error_code = HANGING_PIPE;
-						break;
-					}
-					var_declared = false;
-					piped = false;
-					afterpipe = false;
-				}
-				else {
-					value += ';';
-					if (hanging_apostrophe) {
-						value_str += ';';
-					}
-				}
-			}
-			if (hanging_escape != i) {
-				hanging_escape = 0;
-			}
-		}
-		if (error_code != OK) {
-			break;
-		}
-		if (hanging_var && hanging_arr.empty() && hanging_map.empty()) {
-			error_code = HANGING_VAR;
-			i = hanging_var;
-		}
-		else if (hanging_quote) {
-			error_code = HANGING_QUOTE;
-			i = hanging_quote;
-		}
-		else if (hanging_apostrophe) {
-			error_code = HANGING_APOSTROPHE;
-			i = hanging_apostrophe;
-		}
-		else if (hanging_escape) {
-			error_code = HANGING_ESCAPE;
-			i = hanging_escape;
-		}
-		if (error_code != OK) {
-			break;
-		}
-	}
-	values_str.push_back(value);
-	cout << "\n----\n";
-	for (size_t i = 0; i < vars.size(); i++) {
-		cout << '`' << vars[i] << "` | `" << (values_str.size() > i ? values_str[i] : "") << "`\n";
+		cout << "-------\n";
 	}
-	cout << "----\n\n";
-	if (error_code == OK && (piped && !afterpipe)) {
-		error_code = HANGING_PIPE;
-		i -= 2;
-	}
-	return {error_code, line_num, i, filename};
+	return {};
 }
 
 henifig::error_codes henifig::config_t::print_value(const value_t& x) {
@@ -867,7 +680,7 @@ henifig::error_codes henifig::config_t::print_value(const value_t& x) {
 			break;
 		}
 		case map: {
-			print_map(maps[std::get <map_t>(x).index]);
+			print_map(std::get <map_t>(x));
 			break;
 		}
 		default: {
@@ -921,253 +734,93 @@ henifig::error_codes henifig::config_t::print_map(const value_map& x) {
 	return error_code;
 }
 
-henifig::parse_report henifig::config_t::parse() {
-	error_codes error_code{};
-	for (size_t i = 0; i < vars.size(); i++) {
-		parse_value(i);
+void henifig::config_t::set_track_locations(const bool& track) {
+	track_locations = track;
+}
+
+void henifig::config_t::set_options(const parse_options& new_options) {
+	options = new_options;
+}
+
+const henifig::parse_options& henifig::config_t::get_options() const {
+	return options;
+}
+
+henifig::source_location henifig::config_t::locate(const std::string_view var) const {
+	const auto found = var_nums.find(var);
+	if (found == var_nums.end() || found->second < vars.size() - located_vars) {
+		return {};
 	}
-	cout << "-------\n";
-	for (const value_t& x : values) {
-		error_code = print_value(x);
+	return locations.get(location_table::top, (found->second - (vars.size() - located_vars)) * 2 + 1);
+}
+
+henifig::source_location henifig::config_t::locate_name(const std::string_view var) const {
+	const auto found = var_nums.find(var);
+	if (found == var_nums.end() || found->second < vars.size() - located_vars) {
+		return {};
 	}
-	cout << "-------\n";
-	return {error_code, filename};
+	return locations.get(location_table::top, (found->second - (vars.size() - located_vars)) * 2);
 }
-#define append_to_map(original_value, new_value) \
-	value_t& map_value_ref = original_value; \
-	if (map_value_ref.index() != unset) { \
-		return {REDECLARED_KEY, 0, 0, filename, value.get <std::string>()}; \
-	} \
-	map_value_ref = new_value
 
-henifig::parse_report henifig::config_t::append(depth_t& depth, const value_t& value) {
-	switch (depth.index_type) {
-		case VAR: {
-			values.push_back(value);
-			break;
-		}
-		case ARR: {
-			if (depth.environment_type == VAR) {
-				values.emplace_back(array_t{arrs.size(), this});
-			}
-			else if (depth.environment_type == ARR) {
-				arrs[arr_indexes.top()].emplace_back(array_t{arrs.size(), this});
-			}
-			else {
-				maps[map_indexes.top()][map_keys[depth.map_index]] = array_t{arrs.size(), this};
-			}
-			arr_indexes.push(arrs.size());
-			arrs.emplace_back();
-			depth.environment_type = ARR;
-			break;
-		}
-		case MAP: {
-			if (depth.environment_type == VAR) {
-				values.emplace_back(map_t{maps.size(), this});
-			}
-			else if (depth.environment_type == ARR) {
-				arrs[arr_indexes.top()].emplace_back(map_t{maps.size(), this});
-			}
-			else {
-				maps[map_indexes.top()][map_keys[depth.map_index - 1]] = map_t{maps.size(), this};
-			}
-			map_indexes.push(maps.size());
-			maps.emplace_back();
-			depth.environment_type = MAP;
-			break;
-		}
-		case ARR_ITEM: {
-			arrs[arr_indexes.top()].emplace_back(value);
-			break;
-		}
-		case MAP_KEY: {
-			append_to_map(maps[map_indexes.top()][value.get <std::string>()], declaration_t{});
-			map_keys[depth.map_index] = value.get <std::string>();
-			break;
-		}
-		case MAP_VALUE: {
-			maps[map_indexes.top()][map_keys[depth.map_index]] = value;
-			break;
-		}
-		default: break;
+henifig::source_location henifig::config_t::locate(const value_t& container, const size_t& item) const {
+	if (const array_t* arr = std::get_if <array_t>(&container.value)) {
+		const uint32_t location = locations.find(arr->data);
+		return location != location_table::top ? locations.get(location, item) : source_location();
+	}
+	if (const map_t* items = std::get_if <map_t>(&container.value)) {
+		const uint32_t location = locations.find(items->items);
+		return location != location_table::top ? locations.get(location, item * 2 + 1) : source_location();
 	}
 	return {};
 }
 
-#undef append_to_map
-
-#define appender(depth, value) \
-	const henifig::parse_report report = append(depth, value); \
-	if (report.get_error_code() != OK) \
-		throw parse_exception(parse_report(report.get_error_code(), line_nums[vars[var_num]], 0, report.get_error_filename(), report.get_parse_error_details())) \
-
-#define container_appender(depth) \
-	appender(depth, unset_t{})
+henifig::source_location henifig::config_t::locate(const value_t& map, const std::string_view key) const {
+	const value_map* items = map.get_if <value_map>();
+	if (!items) {
+		return {};
+	}
+	const auto found = items->find(key);
+	return found != items->end() ? locate(map, static_cast <size_t>(found - items->begin())) : source_location();
+}
 
-size_t henifig::config_t::parse_value(const size_t& var_num, const size_t& pos, depth_t depth) {
-	const std::string_view line = values_str[var_num];
-	if (pos >= line.size()) {
-		if (pos == 0) {
-			append(depth, declaration_t{});
-		}
-		return pos;
-	}
-	bool is_signed{};
-	size_t i = pos;
-	switch (line[i]) {
-		case '"': {
-			size_t hanging_escape{};
-			std::string value;
-			for (++i; i < line.size(); i++) {
-				switch (line[i]) {
-					case '\\': {
-						if (hanging_escape) {
-							value += '\\';
-							hanging_escape = 0;
-						}
-						else {
-							hanging_escape = i;
-						}
-						break;
-					}
-					case '"': {
-						if (hanging_escape) {
-							hanging_escape = 0;
-							value += line[i];
-						}
-						else {
-							if (i < line.size() - 1 && line[i + 1] == '"') {
-								++i;
-								break;
-							}
-							appender(depth, value);
-							return parse_value(var_num, i + 1, depth);
-						}
-						break;
-					}
-					default: {
-						if (hanging_escape) {
-							hanging_escape = 0;
-							if (line[i] == 'n') {
-								value += '\n';
-							}
-							else {
-								value += line[i];
-							}
-						}
-						else {
-							value += line[i];
-						}
-						break;
-					}
-				}
-			}
-			break;
-		}
-		case '\'': {
-			char value = line[i + 1];
-			if (value == '\\') {
-				if (line[i + 2] == 'n') {
-					value = '\n';
-				}
-				else {
-					value = line[i + 2];
-				}
-			}
-			appender(depth, value);
-			return parse_value(var_num, i + 4, depth);
-		}
-		case '-' : is_signed = true;
-		case '0' ... '9': {
-			bool is_float{};
-			std::string value;
-			for (;i < line.size(); i++) {
-				if (isdigit(line[i]) || line[i] == '.' || line[i] == '-') {
-					if (line[i] == '.') {
-						is_float = true;
-					}
-					value += line[i];
-				}
-				else {
-					break;
-				}
-			}
-			if (is_float) {
-				appender(depth, std::stod(value));
-			}
-			else if (!is_signed) {
-				appender(depth, std::stoull(value));
-			}
-			else {
-				appender(depth, std::stoll(value));
-			}
-			return parse_value(var_num, i, depth);
-		}
-		case 't': {
-			appender(depth, true);
-			return parse_value(var_num, i + 4, depth);
-		}
-		case 'f': {
-			appender(depth, false);
-			return parse_value(var_num, i + 5, depth);
-		}
-		case '[': {
-			depth_t new_depth = depth;
-			++new_depth.arr_index;
-			new_depth.index_type = ARR;
-			container_appender(new_depth);
-			new_depth.index_type = ARR_ITEM;
-			const size_t new_pos = parse_value(var_num, pos + 1, new_depth);
-			return parse_value(var_num, new_pos, depth);
-		}
-		case '{': {
-			depth_t new_depth = depth;
-			++new_depth.map_index;
-			new_depth.index_type = MAP;
-			container_appender(new_depth);
-			new_depth.index_type = MAP_KEY;
-			const size_t new_pos = parse_value(var_num, pos + 1, new_depth);
-			return parse_value(var_num, new_pos, depth);
-		}
-		case ',': {
-			if (depth.index_type == MAP_VALUE) {
-				depth.index_type = MAP_KEY;
-			}
-			return parse_value(var_num, pos + 1, depth);
-		}
-		case '|': {
-			depth.index_type = MAP_VALUE;
-			return parse_value(var_num, pos + 1, depth);
-		}
-		case ']': {
-			arr_indexes.pop();
-			return i + 1;
-		}
-		case '}': {
-			map_indexes.pop();
-			return i + 1;
-		}
-		default: break;
+henifig::source_location henifig::config_t::locate_key(const value_t& map, const std::string_view key) const {
+	const map_t* items = std::get_if <map_t>(&map.value);
+	if (!items) {
+		return {};
 	}
-	return i;
+	const auto found = items->get().find(key);
+	const uint32_t location = locations.find(items->items);
+	if (found == items->get().end() || location == location_table::top) {
+		return {};
+	}
+	return locations.get(location, static_cast <size_t>(found - items->get().begin()) * 2);
 }
 
-#undef appender
-#undef container_appender
+const henifig::value_t* henifig::config_t::find(const std::string_view key) const {
+	const auto found = var_nums.find(key);
+	return found != var_nums.end() ? &values[found->second] : nullptr;
+}
 
 const henifig::value_t& henifig::config_t::operator [](const std::string_view key) const {
-	try {
-		return values[var_nums.at(key.data())];
-	}
-	catch (const std::out_of_range&) {
-		throw retrieval_exception(std::string("The variable `") + key.data() + "` does not exist.");
+	const auto found = var_nums.find(key);
+	if (found == var_nums.end()) {
+		throw retrieval_exception(std::string("The variable `") + std::string(key) + "` does not exist.");
 	}
+	return values[found->second];
+}
+
+const std::vector <std::string>& henifig::config_t::get_vars() const {
+	return vars;
+}
+
+const henifig::value_t& henifig::config_t::get_value(const size_t& index) const {
+	return values[index];
 }
 
 const henifig::value_array& henifig::config_t::get_arr(const size_t& index) const {
-	return arrs[index];
+	return containers->arrs[index].get();
 }
 
 const henifig::value_map& henifig::config_t::get_map(const size_t& index) const {
-	return maps[index];
+	return containers->maps[index];
 }
@@ -0,0 +1,278 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include "henifig/reader.hpp"
+
+namespace {
+	/**
+	 * @brief Find where the container whose items begin at offset ends, only minding the brackets
+	 * and whatever could hide them: strings, characters and comments.
+	 * @return The position right after the closing bracket, std::string_view::npos if it's never closed.
+	 */
+	size_t find_end(const std::string_view content, size_t offset) {
+		size_t depth = 1;
+		for (; offset < content.size(); offset++) {
+			switch (content[offset]) {
+				case '"':
+				case '\'': {
+					const char quote = content[offset];
+					for (++offset; offset < content.size() && content[offset] != quote; offset++) {
+						if (content[offset] == '\\') {
+							++offset;
+						}
+					}
+					break;
+				}
+				case '#': {
+					offset = content.find('\n', offset);
+					if (offset == std::string_view::npos) {
+						return offset;
+					}
+					break;
+				}
+				case '[': {
+					if (offset + 1 < content.size() && content[offset + 1] == '#') {
+						offset = content.find("#]", offset + 2);
+						if (offset == std::string_view::npos) {
+							return offset;
+						}
+						++offset;
+					}
+					else {
+						++depth;
+					}
+					break;
+				}
+				case '{': {
+					++depth;
+					break;
+				}
+				case ']':
+				case '}': {
+					if (--depth == 0) {
+						return offset + 1;
+					}
+					break;
+				}
+				default: break;
+			}
+		}
+		return std::string_view::npos;
+	}
+
+	bool is_begin(const henifig::reader::token& type) {
+		return type == henifig::reader::token::array_begin || type == henifig::reader::token::map_begin;
+	}
+
+	bool is_end(const henifig::reader::token& type) {
+		return type == henifig::reader::token::array_end || type == henifig::reader::token::map_end;
+	}
+}
+
+void henifig::reader::entry::fix() {
+	if (!is_owned) {
+		return;
+	}
+	if (type == token::scalar) {
+		value = std::string_view(owned);
+	}
+	else {
+		name = owned;
+	}
+}
+
+henifig::error_codes henifig::reader::collector::on_var(std::string_view name) {
+	entry& x = owner.push(token::var);
+	owner.keep(x, name);
+	x.name = name;
+	return OK;
+}
+
+henifig::error_codes henifig::reader::collector::on_key(std::string_view key) {
+	entry& x = owner.push(token::key);
+	owner.keep(x, key);
+	x.name = key;
+	return OK;
+}
+
+henifig::error_codes henifig::reader::collector::on_scalar(const scalar_t& x) {
+	entry& y = owner.push(token::scalar);
+	y.value = x;
+	if (auto* str = std::get_if <std::string_view>(&y.value)) {
+		owner.keep(y, *str);
+	}
+	return OK;
+}
+
+henifig::error_codes henifig::reader::collector::on_array_begin() {
+	owner.push(token::array_begin);
+	return OK;
+}
+
+henifig::error_codes henifig::reader::collector::on_array_end() {
+	owner.push(token::array_end);
+	return OK;
+}
+
+henifig::error_codes henifig::reader::collector::on_map_begin() {
+	owner.push(token::map_begin);
+	return OK;
+}
+
+henifig::error_codes henifig::reader::collector::on_map_end() {
+	owner.push(token::map_end);
+	return OK;
+}
+
+henifig::reader::entry& henifig::reader::push(const token type) {
+	entry& x = queue.emplace_back();
+	x.type = type;
+	x.depth = parser.frames.size();
+	x.line = parser.line;
+	x.index = parser.index;
+	if (is_begin(type)) {
+		// The frame isn't pushed until the handler agrees to it.
+		x.offset = parser.opening;
+	}
+	// Give the caller a chance to look at it before going on.
+	parser.paused = true;
+	return x;
+}
+
+void henifig::reader::keep(entry& x, std::string_view& view) const {
+	if (view.data() >= content.data() && view.data() + view.size() <= content.data() + content.size()) {
+		return;
+	}
+	x.owned = view;
+	x.is_owned = true;
+	view = x.owned;
+}
+
+henifig::reader::reader(const std::string_view content, const std::string_view filename) : content(content), events(*this), parser(events, filename) {
+	parser.reset();
+	parser.chunk = content.data();
+}
+
+bool henifig::reader::next() {
+	while (queue.empty()) {
+		if (parser.error != OK || skip_error != OK || current.type == token::end) {
+			current = entry();
+			current.type = token::end;
+			return false;
+		}
+		if (resume < content.size()) {
+			parser.paused = false;
+			resume = parser.run(content, resume);
+		}
+		else if (!finished) {
+			finished = true;
+			parser.end_input();
+		}
+		else {
+			current = entry();
+			current.type = token::end;
+			return false;
+		}
+	}
+	current = std::move(queue.front());
+	queue.pop_front();
+	current.fix();
+	return true;
+}
+
+bool henifig::reader::next_var() {
+	do {
+		if (is_begin(current.type)) {
+			skip();
+		}
+		if (!next()) {
+			return false;
+		}
+	} while (current.type != token::var);
+	return true;
+}
+
+void henifig::reader::skip() {
+	if (!is_begin(current.type)) {
+		return;
+	}
+	// The container may have been read up to its end along with its beginning.
+	size_t open = 1;
+	while (!queue.empty()) {
+		const token type = queue.front().type;
+		queue.pop_front();
+		if (is_begin(type)) {
+			++open;
+		}
+		else if (is_end(type) && --open == 0) {
+			return;
+		}
+	}
+	const size_t end = find_end(content, current.offset);
+	if (end == std::string_view::npos) {
+		skip_error = current.type == token::array_begin ? HANGING_ARR : HANGING_MAP;
+		skip_line = current.line;
+		skip_index = current.index;
+		return;
+	}
+	// Keep the positions of whatever comes next right.
+	for (; resume < end; resume++) {
+		++parser.index;
+		if (content[resume] == '\n') {
+			++parser.line;
+			parser.index = 0;
+		}
+	}
+	// Pick up as if the parser had closed the container itself.
+	parser.frames.resize(current.depth);
+	parser.current = parser.frames.empty() ? sax_parser::state::var_end : sax_parser::state::after_value;
+	parser.comment = sax_parser::comment_state::none;
+	parser.pending = 0;
+	parser.token.clear();
+	parser.view_begin = parser.view_end = NPOS;
+}
+
+henifig::reader::token henifig::reader::type() const {
+	return current.type;
+}
+
+std::string_view henifig::reader::name() const {
+	return current.name;
+}
+
+const henifig::scalar_t& henifig::reader::scalar() const {
+	return current.value;
+}
+
+size_t henifig::reader::depth() const {
+	return current.depth;
+}
+
+size_t henifig::reader::get_line() const {
+	return current.line;
+}
+
+size_t henifig::reader::get_index() const {
+	return current.index;
+}
+
+henifig::parse_report henifig::reader::get_report() const {
+	if (skip_error != OK) {
+		return {skip_error, skip_line, skip_index, parser.filename};
+	}
+	return parser.report();
+}
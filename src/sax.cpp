@@ -0,0 +1,973 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+
+#include "henifig/sax.hpp"
+
+namespace {
+	constexpr std::string_view include_syntax = R"(@include "path/to/file.hfg")";
+
+	bool is_space(const char c) {
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	bool is_blank(const char c) {
+		return is_space(c) || c == '\n';
+	}
+}
+
+henifig::error_codes henifig::sax_handler::on_var(std::string_view) {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_key(std::string_view) {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_scalar(const scalar_t&) {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_array_begin() {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_array_end() {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_map_begin() {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_map_end() {
+	return OK;
+}
+
+henifig::error_codes henifig::sax_handler::on_include(std::string_view) {
+	return OK;
+}
+
+henifig::sax_parser::sax_parser(sax_handler& handler, const std::string_view filename) : handler(&handler), filename(filename) {}
+
+size_t henifig::sax_parser::get_line() const {
+	return line;
+}
+
+size_t henifig::sax_parser::get_index() const {
+	return index;
+}
+
+size_t henifig::sax_parser::get_token_line() const {
+	return literal_line;
+}
+
+size_t henifig::sax_parser::get_token_index() const {
+	return literal_index;
+}
+
+henifig::parse_report henifig::sax_parser::parse(const std::string_view content) {
+	reset();
+	feed(content);
+	return finish();
+}
+
+void henifig::sax_parser::reset() {
+	current = state::top;
+	comment = comment_state::none;
+	pending = 0;
+	frames.clear();
+	token.clear();
+	view_begin = view_end = NPOS;
+	line = 1;
+	index = 0;
+	line_blank = true;
+	started = false;
+	paused = false;
+	bytes_read = nodes = vars = 0;
+	error = OK;
+	error_details.clear();
+}
+
+henifig::parse_report henifig::sax_parser::report() const {
+	if (error != OK) {
+		return {error, error_line, error_index, filename, error_details};
+	}
+	return {};
+}
+
+size_t henifig::sax_parser::run(const std::string_view content, const size_t from) {
+	pos = from;
+	while (pos < content.size() && error == OK && !paused) {
+		const size_t used = usage ? usage->bytes.load(std::memory_order_relaxed) : bytes_read;
+		if (!within(used + 1, options.max_input_bytes, INPUT_TOO_LARGE)) {
+			break;
+		}
+		// The limits are looked at between blocks of input, keeping the loop over the characters as tight as it was.
+		const size_t begin = pos;
+		const size_t end = pos + std::min({content.size() - pos, block_size, options.max_input_bytes - used});
+		for (; pos < end && error == OK && !paused; pos++) {
+			const char c = content[pos];
+			++index;
+			put(c);
+			if (c == '\n') {
+				++line;
+				index = 0;
+			}
+			if (error != OK && recovering && !is_limit(error)) {
+				recover(c);
+			}
+			line_blank = c == '\n' || (line_blank && is_space(c));
+		}
+		charge(bytes_read, &parse_usage::bytes, pos - begin);
+		// A literal is checked as a whole once it ends, this only stops one from growing on for too long.
+		within(token.size() + (view_begin != NPOS ? (view_end != NPOS ? view_end : pos) - view_begin : 0),
+		options.max_string_length, LITERAL_TOO_LONG);
+		check_time();
+	}
+	return pos;
+}
+
+void henifig::sax_parser::recover(const char c) {
+	errors.push_back(report());
+	// Close whatever was left open, for the handler to see as many ends as beginnings.
+	while (!frames.empty()) {
+		const data_types type = frames.back().type;
+		frames.pop_back();
+		type == array ? handler->on_array_end() : handler->on_map_end();
+	}
+	token.clear();
+	view_begin = view_end = NPOS;
+	error = OK;
+	error_details.clear();
+	current = state::recover;
+	// The character which failed might be where the next declaration begins.
+	if (comment == comment_state::none && !pending) {
+		step(c);
+	}
+}
+
+bool henifig::sax_parser::within(const size_t count, const size_t limit, const error_codes code) {
+	if (count > limit) {
+		fail(code, std::to_string(limit));
+		return false;
+	}
+	return true;
+}
+
+size_t henifig::sax_parser::charge(size_t& own, std::atomic <size_t> parse_usage::* const shared, const size_t amount) {
+	own += amount;
+	return usage ? (usage->*shared).fetch_add(amount, std::memory_order_relaxed) + amount : own;
+}
+
+bool henifig::sax_parser::add_node() {
+	if (!within(charge(nodes, &parse_usage::nodes, 1), options.max_nodes, TOO_MANY_NODES)) {
+		return false;
+	}
+	return frames.empty() || frames.back().type != array ||
+	within(++frames.back().items, options.max_container_size, CONTAINER_TOO_BIG);
+}
+
+henifig::error_codes henifig::sax_parser::scalar(const scalar_t& x) {
+	if (const std::string_view* str = std::get_if <std::string_view>(&x); str && !within(str->size(), options.max_string_length, LITERAL_TOO_LONG)) {
+		return OK;
+	}
+	return add_node() ? handler->on_scalar(x) : OK;
+}
+
+henifig::error_codes henifig::sax_parser::var(const std::string_view name) {
+	return within(name.size(), options.max_string_length, LITERAL_TOO_LONG) && within(charge(vars, &parse_usage::vars, 1), options.max_vars, TOO_MANY_VARS) ?
+	handler->on_var(name) : OK;
+}
+
+void henifig::sax_parser::check_time() {
+	if (options.cancel && options.cancel->load(std::memory_order_relaxed)) {
+		fail(PARSE_CANCELLED);
+	}
+	else if (options.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() > options.deadline) {
+		fail(DEADLINE_EXCEEDED);
+	}
+}
+
+bool henifig::sax_parser::is_limit(const error_codes code) {
+	return code >= INPUT_TOO_LARGE && code <= DEADLINE_EXCEEDED;
+}
+
+void henifig::sax_parser::set_options(const parse_options& new_options) {
+	options = new_options;
+}
+
+const henifig::parse_options& henifig::sax_parser::get_options() const {
+	return options;
+}
+
+void henifig::sax_parser::set_usage(parse_usage* const shared) {
+	usage = shared;
+}
+
+void henifig::sax_parser::set_recovery(const bool& enabled) {
+	recovering = enabled;
+}
+
+const std::vector <henifig::parse_report>& henifig::sax_parser::get_errors() const {
+	return errors;
+}
+
+bool henifig::sax_parser::feed(const std::string_view chunk) {
+	if (!started) {
+		errors.clear();
+		started = true;
+		// Even a document too small to reach the next check shouldn't start once it's too late.
+		check_time();
+	}
+	this->chunk = chunk.data();
+	run(chunk, 0);
+	// A view can't outlive the input it's looking at.
+	if (view_begin != NPOS) {
+		flush_view(chunk.size());
+	}
+	this->chunk = nullptr;
+	return error == OK;
+}
+
+henifig::parse_report henifig::sax_parser::finish() {
+	if (!started) {
+		errors.clear();
+	}
+	end_input();
+	if (error != OK && recovering) {
+		recover('\n');
+	}
+	parse_report res = errors.empty() ? report() : errors.front();
+	reset();
+	return res;
+}
+
+void henifig::sax_parser::end_input() {
+	if (error != OK) {
+		return;
+	}
+	// The end of the input ends whatever a new line would.
+	put('\n');
+	if (error != OK) {
+		return;
+	}
+	if (comment == comment_state::block || comment == comment_state::block_hash) {
+		return fail_at(HANGING_COMMENT, comment_line, comment_index);
+	}
+	if (current == state::string_end) {
+		end_string();
+		if (error != OK) {
+			return;
+		}
+	}
+	if (!frames.empty()) {
+		const frame& hanging = frames.back();
+		return fail_at(hanging.type == array ? HANGING_ARR : HANGING_MAP, hanging.line, hanging.index);
+	}
+	switch (current) {
+		case state::value: {
+			fail(HANGING_PIPE);
+			break;
+		}
+		case state::var_end: {
+			fail(HANGING_VAR);
+			break;
+		}
+		case state::keyword: {
+			fail(UNKNOWN_EXPRESSION);
+			break;
+		}
+		case state::directive:
+		case state::directive_path: {
+			fail(EXPECTED_EXPRESSION, include_syntax);
+			break;
+		}
+		default: break;
+	}
+}
+
+bool henifig::sax_parser::raw() const {
+	switch (current) {
+		case state::name:
+		case state::path:
+		case state::string:
+		case state::string_escape:
+		case state::character:
+		case state::character_escape:
+		case state::character_end:
+		case state::key:
+		case state::key_escape: {
+			return true;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+void henifig::sax_parser::put(const char c) {
+	switch (comment) {
+		case comment_state::line: {
+			if (c == '\n') {
+				comment = comment_state::none;
+				step(c);
+			}
+			return;
+		}
+		case comment_state::block: {
+			if (c == '#') {
+				comment = comment_state::block_hash;
+			}
+			else if (c == ']' && line == comment_line && index == comment_index + 1) {
+				fail(IMPROPERLY_CLOSED_COMMENT);
+			}
+			return;
+		}
+		case comment_state::block_hash: {
+			if (c == ']') {
+				comment = comment_state::none;
+				// The comment still separates whatever is around it.
+				step(' ');
+			}
+			else if (c != '#') {
+				comment = comment_state::block;
+			}
+			return;
+		}
+		default: break;
+	}
+	if (pending == '[') {
+		pending = 0;
+		if (c == '#') {
+			comment = comment_state::block;
+			comment_line = line;
+			comment_index = index;
+			return;
+		}
+		step('[');
+		if (error == OK) {
+			put(c);
+		}
+		return;
+	}
+	if (pending == '#') {
+		pending = 0;
+		if (c == ']') {
+			return fail(NO_OPENED_COMMENT);
+		}
+		comment = comment_state::line;
+		return put(c);
+	}
+	if (!raw() && (c == '[' || c == '#')) {
+		pending = c;
+		pending_line = line;
+		pending_index = index;
+		return;
+	}
+	step(c);
+}
+
+void henifig::sax_parser::step(const char c) {
+	switch (current) {
+		case state::top: {
+			if (is_blank(c) || c == ';') {
+				break;
+			}
+			if (c == '/') {
+				token.clear();
+				literal_line = line;
+				literal_index = index;
+				current = state::name;
+			}
+			else if (c == '@') {
+				token.clear();
+				current = state::directive;
+			}
+			else {
+				fail(c == '|' ? NAKED_PIPE : UNKNOWN_EXPRESSION);
+			}
+			break;
+		}
+		case state::name: {
+			if (c == '\\') {
+				current = state::name_escape;
+			}
+			else if (c == '[' || c == '{') {
+				check(var(token), token);
+				if (error == OK) {
+					open(c == '[' ? array : map, pos + 1, line, index);
+				}
+			}
+			else if (c == '\n') {
+				fail_at(HANGING_VAR, literal_line, literal_index);
+			}
+			else {
+				token += c;
+			}
+			break;
+		}
+		case state::name_escape: {
+			if (c == '\\') {
+				token += '\\';
+				current = state::name;
+				break;
+			}
+			check(var(token), token);
+			current = state::after_name;
+			if (error == OK) {
+				step(c);
+			}
+			break;
+		}
+		case state::after_name: {
+			if (is_space(c)) {
+				break;
+			}
+			if (c == '|') {
+				current = state::value;
+			}
+			else if (c == '\n' || c == ';' || c == '/') {
+				check(scalar(declaration_t{}));
+				current = state::top;
+				if (c == '/' && error == OK) {
+					step(c);
+				}
+			}
+			else {
+				fail(UNEXPECTED_EXPRESSION);
+			}
+			break;
+		}
+		case state::directive: {
+			if (c >= 'a' && c <= 'z') {
+				token += c;
+				break;
+			}
+			if (token != "include") {
+				fail(UNKNOWN_EXPRESSION, token);
+				break;
+			}
+			current = state::directive_path;
+			step(c);
+			break;
+		}
+		case state::directive_path: {
+			if (is_space(c)) {
+				break;
+			}
+			if (c != '"') {
+				fail(EXPECTED_EXPRESSION, include_syntax);
+				break;
+			}
+			token.clear();
+			literal_line = line;
+			literal_index = index;
+			current = state::path;
+			break;
+		}
+		case state::path: {
+			if (c == '"') {
+				current = state::directive_end;
+			}
+			else if (c == '\n') {
+				fail_at(HANGING_QUOTE, literal_line, literal_index);
+			}
+			else {
+				token += c;
+			}
+			break;
+		}
+		case state::directive_end: {
+			if (is_space(c)) {
+				break;
+			}
+			if (c == '\n' || c == ';') {
+				if (within(token.size(), options.max_string_length, LITERAL_TOO_LONG)) {
+					check(handler->on_include(token), token);
+				}
+				current = state::top;
+			}
+			else {
+				fail(EXPECTED_EXPRESSION, include_syntax);
+			}
+			break;
+		}
+		case state::value: {
+			if (is_blank(c)) {
+				break;
+			}
+			if (frames.empty()) {
+				if (c == '/' || c == '|' || c == ';') {
+					fail(HANGING_PIPE);
+					break;
+				}
+				if (c == '[' || c == '{') {
+					fail(c == '[' ? UNEXPECTED_ARR : UNEXPECTED_MAP);
+					break;
+				}
+			}
+			else if (c == '$') {
+				fail(PIPED_KEY);
+				break;
+			}
+			else if (c == ',' || c == '}' || c == '|') {
+				fail(HANGING_PIPE);
+				break;
+			}
+			start_value(c);
+			break;
+		}
+		case state::string:
+		case state::key: {
+			if (c == '\\') {
+				if (view_begin != NPOS) {
+					flush_view(pos);
+				}
+				current = current == state::string ? state::string_escape : state::key_escape;
+			}
+			else if (c == '"') {
+				if (view_begin != NPOS) {
+					view_end = pos;
+				}
+				if (current == state::key) {
+					const std::string_view key = literal();
+					if (within(key.size(), options.max_string_length, LITERAL_TOO_LONG) &&
+					within(++frames.back().items, options.max_container_size, CONTAINER_TOO_BIG)) {
+						check(handler->on_key(key), key);
+					}
+					view_begin = view_end = NPOS;
+					current = state::after_key;
+				}
+				else {
+					newline_in_literal = false;
+					current = state::string_end;
+				}
+			}
+			else if (c == '\n') {
+				fail_at(HANGING_QUOTE, literal_line, literal_index);
+			}
+			else if (view_begin == NPOS) {
+				token += c;
+			}
+			break;
+		}
+		case state::string_escape:
+		case state::key_escape:
+		case state::character_escape: {
+			if (c == ' ' || c == '\n') {
+				fail(HANGING_ESCAPE);
+				break;
+			}
+			if (c != 'n' && !std::ispunct(static_cast <unsigned char>(c))) {
+				fail(UNDEFINED_ESCAPE);
+				break;
+			}
+			token += c == 'n' ? '\n' : c;
+			current = current == state::string_escape ? state::string : current == state::key_escape ? state::key : state::character_end;
+			break;
+		}
+		case state::string_end: {
+			if (is_blank(c)) {
+				newline_in_literal |= c == '\n';
+				break;
+			}
+			if (c == '"') {
+				// Adjacent strings make up a single one.
+				if (view_begin != NPOS) {
+					flush_view(pos);
+				}
+				current = state::string;
+				break;
+			}
+			end_string();
+			if (error == OK) {
+				step(c);
+			}
+			break;
+		}
+		case state::character: {
+			if (c == '\\') {
+				current = state::character_escape;
+			}
+			else if (c == '\'') {
+				fail(NO_CHARS);
+			}
+			else if (c == '\n') {
+				fail_at(HANGING_APOSTROPHE, literal_line, literal_index);
+			}
+			else {
+				token += c;
+				current = state::character_end;
+			}
+			break;
+		}
+		case state::character_end: {
+			if (c == '\'') {
+				check(scalar(token[0]));
+				current = state::after_value;
+			}
+			else if (c == '\n') {
+				fail_at(HANGING_APOSTROPHE, literal_line, literal_index);
+			}
+			else {
+				fail(MULTIPLE_CHARS);
+			}
+			break;
+		}
+		case state::number: {
+			if (c >= '0' && c <= '9') {
+				token += c;
+			}
+			else if (c == '.') {
+				if (is_float) {
+					fail(REPEATED_DOT);
+					break;
+				}
+				is_float = true;
+				token += c;
+			}
+			else if (c == '-') {
+				fail(MINUS_IN_MIDDLE);
+			}
+			else {
+				end_number();
+				current = state::after_value;
+				if (error == OK) {
+					step(c);
+				}
+			}
+			break;
+		}
+		case state::keyword: {
+			token += c;
+			if (token == "true" || token == "false") {
+				check(scalar(token == "true"));
+				current = state::after_value;
+			}
+			else if (std::string_view("true").substr(0, token.size()) != token && std::string_view("false").substr(0, token.size()) != token) {
+				fail(UNKNOWN_EXPRESSION);
+			}
+			break;
+		}
+		case state::after_value: {
+			if (frames.empty()) {
+				if (is_space(c)) {
+					break;
+				}
+				if (c == '\n' || c == ';') {
+					current = state::top;
+				}
+				else {
+					fail(c == '/' ? MISSING_SEMICOLON : UNEXPECTED_EXPRESSION);
+				}
+				break;
+			}
+			if (is_blank(c)) {
+				break;
+			}
+			if (c == '\\') {
+				fail_at(frames.back().type == array ? HANGING_ARR : HANGING_MAP, frames.back().line, frames.back().index);
+				break;
+			}
+			if (frames.back().type == array) {
+				if (c == ',') {
+					current = state::array_next;
+				}
+				else if (c == ']') {
+					close(array);
+				}
+				else {
+					fail(c == '}' ? ARR_COMPLETED_WITH_MAP : UNEXPECTED_EXPRESSION);
+				}
+			}
+			else {
+				if (c == ',') {
+					current = state::map_next;
+				}
+				else if (c == '}') {
+					close(map);
+				}
+				else {
+					fail(c == ']' ? MAP_COMPLETED_WITH_ARR : c == '|' ? PIPED_VALUE : UNEXPECTED_EXPRESSION);
+				}
+			}
+			break;
+		}
+		case state::array_first:
+		case state::array_next: {
+			if (is_blank(c)) {
+				break;
+			}
+			if (c == ']') {
+				if (current == state::array_next) {
+					fail(HANGING_COMMA);
+				}
+				else {
+					close(array);
+				}
+			}
+			else if (c == ',') {
+				fail(current == state::array_first ? UNEXPECTED_COMMA : EXPECTED_EXPRESSION);
+			}
+			else {
+				start_value(c);
+			}
+			break;
+		}
+		case state::map_first:
+		case state::map_next: {
+			if (is_blank(c)) {
+				break;
+			}
+			if (c == '}') {
+				if (current == state::map_next) {
+					fail(HANGING_COMMA);
+				}
+				else {
+					close(map);
+				}
+			}
+			else if (c == '$') {
+				literal_line = line;
+				literal_index = index;
+				current = state::dollar;
+			}
+			else if (c == ',') {
+				fail(current == state::map_first ? UNEXPECTED_COMMA : EXPECTED_EXPRESSION);
+			}
+			else {
+				fail(EXPECTED_DOLLAR);
+			}
+			break;
+		}
+		case state::dollar: {
+			if (c != '"') {
+				fail(c == '$' ? REPEATED_DOLLAR : HANGING_DOLLAR);
+				break;
+			}
+			token.clear();
+			view_begin = pos + 1;
+			view_end = NPOS;
+			current = state::key;
+			break;
+		}
+		case state::after_key: {
+			if (is_blank(c)) {
+				break;
+			}
+			if (c == '|') {
+				current = state::value;
+			}
+			else if (c == ',' || c == '}') {
+				// A key without a value is a declaration.
+				check(scalar(declaration_t{}));
+				if (error != OK) {
+					break;
+				}
+				if (c == ',') {
+					current = state::map_next;
+				}
+				else {
+					close(map);
+				}
+			}
+			else {
+				fail(UNEXPECTED_EXPRESSION);
+			}
+			break;
+		}
+		case state::var_end: {
+			if (is_space(c)) {
+				break;
+			}
+			if (c == '\\') {
+				current = state::top;
+			}
+			else {
+				fail(HANGING_VAR);
+			}
+			break;
+		}
+		case state::recover: {
+			if ((c == '/' || c == '@') && line_blank) {
+				current = state::top;
+				step(c);
+			}
+			break;
+		}
+	}
+}
+
+void henifig::sax_parser::start_value(const char c) {
+	token.clear();
+	literal_line = line;
+	literal_index = index;
+	switch (c) {
+		case '"': {
+			view_begin = pos + 1;
+			view_end = NPOS;
+			current = state::string;
+			break;
+		}
+		case '\'': {
+			current = state::character;
+			break;
+		}
+		case '[': {
+			// The '[' was held back in case it began a comment, pos is already past it.
+			open(array, pos, pending_line, pending_index);
+			break;
+		}
+		case '{': {
+			open(map, pos + 1, line, index);
+			break;
+		}
+		case 't':
+		case 'f': {
+			token += c;
+			current = state::keyword;
+			break;
+		}
+		case '$': {
+			fail(UNEXPECTED_DOLLAR);
+			break;
+		}
+		case ']': {
+			fail(!frames.empty() && frames.back().type == map ? MAP_COMPLETED_WITH_ARR : UNEXPECTED_ARR_END);
+			break;
+		}
+		case '}': {
+			fail(!frames.empty() && frames.back().type == array ? ARR_COMPLETED_WITH_MAP : UNEXPECTED_MAP_END);
+			break;
+		}
+		default: {
+			if ((c >= '0' && c <= '9') || c == '-' || c == '.') {
+				token += c;
+				is_float = c == '.';
+				current = state::number;
+			}
+			else {
+				fail(UNKNOWN_EXPRESSION);
+			}
+		}
+	}
+}
+
+void henifig::sax_parser::open(const data_types type, const size_t offset, const size_t open_line, const size_t open_index) {
+	if (!add_node() || !within(frames.size() + 1, options.max_depth, TOO_DEEP)) {
+		return;
+	}
+	opening = offset;
+	literal_line = open_line;
+	literal_index = open_index;
+	check(type == array ? handler->on_array_begin() : handler->on_map_begin());
+	frames.push_back({type, open_line, open_index, offset});
+	current = type == array ? state::array_first : state::map_first;
+}
+
+void henifig::sax_parser::close(const data_types type) {
+	frames.pop_back();
+	check(type == array ? handler->on_array_end() : handler->on_map_end());
+	current = frames.empty() ? state::var_end : state::after_value;
+}
+
+void henifig::sax_parser::end_number() {
+	if (!within(token.size(), options.max_string_length, LITERAL_TOO_LONG)) {
+		return;
+	}
+	if (token.back() == '.') {
+		return fail(HANGING_DOT);
+	}
+	if (token == "-") {
+		return fail(EXPECTED_EXPRESSION);
+	}
+	// -.1 is -0.1
+	if (token[0] == '.' || (token[0] == '-' && token[1] == '.')) {
+		token.insert(token[0] == '.' ? 0 : 1, 1, '0');
+	}
+	const char* const begin = token.data();
+	const char* const end = begin + token.size();
+	scalar_t x;
+	std::from_chars_result res{};
+	if (is_float) {
+		double y{};
+		res = std::from_chars(begin, end, y);
+		x = y;
+	}
+	else if (token[0] == '-') {
+		long long y{};
+		res = std::from_chars(begin, end, y);
+		x = y;
+	}
+	else {
+		unsigned long long y{};
+		res = std::from_chars(begin, end, y);
+		x = y;
+	}
+	if (res.ec != std::errc() || res.ptr != end) {
+		return fail(WRONG_EXPRESSION, token);
+	}
+	check(scalar(x));
+}
+
+void henifig::sax_parser::end_string() {
+	check(scalar(literal()));
+	view_begin = view_end = NPOS;
+	current = frames.empty() && newline_in_literal ? state::top : state::after_value;
+}
+
+void henifig::sax_parser::flush_view(const size_t end) {
+	token.append(chunk + view_begin, (view_end != NPOS ? view_end : end) - view_begin);
+	view_begin = view_end = NPOS;
+}
+
+std::string_view henifig::sax_parser::literal() const {
+	if (view_begin != NPOS) {
+		return {chunk + view_begin, view_end - view_begin};
+	}
+	return token;
+}
+
+void henifig::sax_parser::check(const error_codes code, const std::string_view details) {
+	if (code != OK) {
+		fail(code, details);
+	}
+}
+
+void henifig::sax_parser::fail(const error_codes code, const std::string_view details) {
+	fail_at(code, line, index, details);
+}
+
+void henifig::sax_parser::fail_at(const error_codes code, const size_t error_line, const size_t error_index, const std::string_view details) {
+	if (error != OK) {
+		return;
+	}
+	error = code;
+	this->error_line = error_line;
+	this->error_index = error_index;
+	// A single hostile token can be megabytes long, only its beginning is worth reporting.
+	if (details.size() > max_details) {
+		error_details.assign(details.substr(0, max_details)).append("...");
+	}
+	else {
+		error_details = details;
+	}
+}
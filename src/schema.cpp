@@ -0,0 +1,414 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <cstdio>
+
+#include "henifig/bind.hpp"
+#include "henifig/schema.hpp"
+
+namespace {
+	std::string number(const double& x) {
+		char buffer[32];
+		std::snprintf(buffer, sizeof(buffer), "%.15g", x);
+		return buffer;
+	}
+
+	std::string bounds(const size_t& min, const size_t& max) {
+		if (max == henifig::NPOS) {
+			return "at least " + std::to_string(min);
+		}
+		if (min == max) {
+			return std::to_string(min);
+		}
+		return "between " + std::to_string(min) + " and " + std::to_string(max);
+	}
+}
+
+henifig::schema::schema(const data_types type) : type(type) {}
+
+henifig::schema henifig::schema::any() {
+	return schema(unset);
+}
+
+henifig::schema henifig::schema::string() {
+	return schema(henifig::string);
+}
+
+henifig::schema henifig::schema::character() {
+	return schema(henifig::character);
+}
+
+henifig::schema henifig::schema::boolean() {
+	return schema(henifig::boolean);
+}
+
+henifig::schema henifig::schema::integer() {
+	schema res(unset);
+	res.integral = true;
+	return res;
+}
+
+henifig::schema henifig::schema::number() {
+	schema res(unset);
+	res.numeric = true;
+	return res;
+}
+
+henifig::schema henifig::schema::array(const schema& items) {
+	schema res(henifig::array);
+	res.items = std::make_shared <const schema>(items);
+	return res;
+}
+
+henifig::schema henifig::schema::map() {
+	return schema(henifig::map);
+}
+
+henifig::schema& henifig::schema::range(const double min, const double max) {
+	this->min = min;
+	this->max = max;
+	return *this;
+}
+
+henifig::schema& henifig::schema::one_of(std::vector <std::string> choices) {
+	this->choices = std::move(choices);
+	return *this;
+}
+
+henifig::schema& henifig::schema::length(const size_t min, const size_t max) {
+	min_length = min;
+	max_length = max;
+	return *this;
+}
+
+henifig::schema& henifig::schema::key(const std::string_view name, const schema& value, const bool required) {
+	keys.push_back({std::string(name), std::make_shared <const schema>(value), required});
+	return *this;
+}
+
+henifig::schema& henifig::schema::required(const std::string_view name, const schema& value) {
+	return key(name, value, true);
+}
+
+henifig::schema& henifig::schema::optional(const std::string_view name, const schema& value) {
+	return key(name, value, false);
+}
+
+henifig::schema& henifig::schema::closed() {
+	closed_map = true;
+	return *this;
+}
+
+henifig::compiled_schema henifig::schema::compile() const {
+	return compiled_schema(*this);
+}
+
+uint32_t henifig::compiled_schema::add(program& code, const schema& s) {
+	const auto at = static_cast <uint32_t>(code.rules.size());
+	code.rules.emplace_back();
+	rule r;
+	r.type = s.type;
+	r.integral = s.integral;
+	r.numeric = s.numeric;
+	r.closed = s.closed_map;
+	r.has_min = s.min.has_value();
+	r.has_max = s.max.has_value();
+	r.min = s.min.value_or(0);
+	r.max = s.max.value_or(0);
+	r.min_length = s.min_length;
+	r.max_length = s.max_length;
+	r.first_choice = static_cast <uint32_t>(code.choices.size());
+	r.choice_count = static_cast <uint32_t>(s.choices.size());
+	code.choices.insert(code.choices.end(), s.choices.begin(), s.choices.end());
+	// The keys of a map are laid out before those of the maps within it so they stay next to each other.
+	r.first_key = static_cast <uint32_t>(code.keys.size());
+	r.key_count = static_cast <uint32_t>(s.keys.size());
+	for (const schema::key_t& key : s.keys) {
+		code.keys.push_back({key.name, 0, key.required});
+		r.required_count += key.required;
+	}
+	for (uint32_t i = 0; i < r.key_count; i++) {
+		const uint32_t child = add(code, *s.keys[i].value);
+		code.keys[r.first_key + i].rule = child;
+	}
+	if (s.items) {
+		r.items = add(code, *s.items);
+	}
+	code.rules[at] = r;
+	return at;
+}
+
+henifig::compiled_schema::compiled_schema(const schema& root) {
+	const auto compiled = std::make_shared <program>();
+	add(*compiled, root);
+	// The indexes view the names of the keys, so they're made once those are where they'll stay.
+	for (rule& r : compiled->rules) {
+		if (r.key_count <= index_threshold) {
+			continue;
+		}
+		r.index = compiled->indexes.size();
+		auto& index = compiled->indexes.emplace_back();
+		for (uint32_t i = 0; i < r.key_count; i++) {
+			index.emplace(compiled->keys[r.first_key + i].name, i);
+		}
+	}
+	code = compiled;
+}
+
+std::string henifig::compiled_schema::path_of(const step* path) {
+	std::vector <const step*> steps;
+	for (; path; path = path->parent) {
+		steps.push_back(path);
+	}
+	std::string res;
+	for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+		if ((*it)->index != NPOS) {
+			res += '[' + std::to_string((*it)->index) + ']';
+		}
+		else {
+			if (!res.empty()) {
+				res += '.';
+			}
+			res += (*it)->key;
+		}
+	}
+	return res;
+}
+
+const henifig::compiled_schema::key_rule* henifig::compiled_schema::find_key(const rule& r, const std::string_view name) const {
+	if (r.index != NPOS) {
+		const auto& index = code->indexes[r.index];
+		const auto found = index.find(name);
+		return found != index.end() ? &code->keys[r.first_key + found->second] : nullptr;
+	}
+	for (uint32_t i = r.first_key; i < r.first_key + r.key_count; i++) {
+		const key_rule& key = code->keys[i];
+		if (key.name.size() == name.size() && key.name == name) {
+			return &key;
+		}
+	}
+	return nullptr;
+}
+
+void henifig::compiled_schema::check(const rule& r, const value_t& value, const step* path, schema_violations& out, validation_scratch& scratch) const {
+	const size_t index = value.index();
+	if (r.type == unset && !r.integral && !r.numeric) {
+		return;
+	}
+	const bool is_integer = index == ulonglong || index == longlong;
+	const bool fits = r.integral ? is_integer : r.numeric ? is_integer || index == floating : index == r.type;
+	if (!fits) {
+		const char* expected = r.integral ? "integer" : r.numeric ? "number" : detail::type_name(r.type);
+		out.push_back({path_of(path), std::string("expected ") + expected + ", got " + detail::type_name(index)});
+		return;
+	}
+	switch (index) {
+		case array: {
+			check_array(r, std::get <array_t>(value.value), path, out, scratch);
+			break;
+		}
+		case map: {
+			const value_map& items = value.get <value_map>();
+			check_map(r, items.size(), [&items](const size_t& i) -> const value_map::value_type& {
+				return *(items.begin() + static_cast <std::ptrdiff_t>(i));
+			}, path, out, scratch);
+			break;
+		}
+		default: {
+			check_scalar(r, value, path, out);
+		}
+	}
+}
+
+void henifig::compiled_schema::check_range(const rule& r, const double x, const step* path, schema_violations& out) const {
+	if ((r.has_min && x < r.min) || (r.has_max && x > r.max)) {
+		std::string expected = r.has_min && r.has_max ? "between " + number(r.min) + " and " + number(r.max) :
+		r.has_min ? "at least " + number(r.min) : "at most " + number(r.max);
+		out.push_back({path_of(path), number(x) + " is out of range, expected " + expected});
+	}
+}
+
+void henifig::compiled_schema::check_scalar(const rule& r, const value_t& value, const step* path, schema_violations& out) const {
+	switch (value.index()) {
+		case string: {
+			const std::string_view text = value.get <std::string_view>();
+			if (text.size() < r.min_length || text.size() > r.max_length) {
+				out.push_back({path_of(path), std::to_string(text.size()) + " characters, expected " + bounds(r.min_length, r.max_length)});
+			}
+			if (!r.choice_count) {
+				break;
+			}
+			for (uint32_t i = r.first_choice; i < r.first_choice + r.choice_count; i++) {
+				if (code->choices[i] == text) {
+					return;
+				}
+			}
+			out.push_back({path_of(path), '`' + std::string(text) + "` isn't one of the allowed values"});
+			break;
+		}
+		case floating: {
+			check_range(r, value.get <double>(), path, out);
+			break;
+		}
+		case ulonglong: {
+			check_range(r, static_cast <double>(value.get <unsigned long long>()), path, out);
+			break;
+		}
+		case longlong: {
+			check_range(r, static_cast <double>(value.get <long long>()), path, out);
+			break;
+		}
+		default: {
+		}
+	}
+}
+
+void henifig::compiled_schema::check_array(const rule& r, const array_t& arr, const step* path, schema_violations& out, validation_scratch& scratch) const {
+	const size_t size = arr.size();
+	if (size < r.min_length || size > r.max_length) {
+		out.push_back({path_of(path), std::to_string(size) + " items, expected " + bounds(r.min_length, r.max_length)});
+	}
+	const rule& item = code->rules[r.items];
+	if (item.type == unset && !item.integral && !item.numeric) {
+		return;
+	}
+	// Packed items all have the same type, which only needs checking once; they're never boxed for it.
+	const packed_array& packed = arr.packed();
+	const data_types packed_type = packed.type();
+	const bool packed_fits = item.integral ? packed_type == ulonglong || packed_type == longlong :
+	item.numeric ? packed_type != unset && packed_type != boolean : packed_type == item.type;
+	if (packed_type != unset && packed_fits) {
+		if (!item.has_min && !item.has_max) {
+			return;
+		}
+		const auto check_items = [&](const auto items) {
+			for (size_t i = 0; i < items.size(); i++) {
+				const step at{path, {}, i};
+				check_range(item, static_cast <double>(items[i]), &at, out);
+			}
+		};
+		switch (packed_type) {
+			case floating: {
+				check_items(packed.get <double>());
+				break;
+			}
+			case ulonglong: {
+				check_items(packed.get <unsigned long long>());
+				break;
+			}
+			default: {
+				check_items(packed.get <long long>());
+			}
+		}
+		return;
+	}
+	const value_array& items = arr.get();
+	for (size_t i = 0; i < items.size(); i++) {
+		const step at{path, {}, i};
+		check(item, items[i], &at, out, scratch);
+	}
+}
+
+template <typename At>
+void henifig::compiled_schema::check_map(const rule& r, const size_t count, const At& at, const step* path, schema_violations& out, validation_scratch& scratch) const {
+	// Which keys were found, in a word unless the map has lots of them. Those get words of their own
+	// on top of the ones of the maps they're in, given back once they're checked.
+	uint64_t seen_small{};
+	const bool big = r.key_count > 64;
+	const size_t first_word = scratch.seen.size();
+	if (big) {
+		scratch.seen.resize(first_word + (r.key_count + 63) / 64);
+	}
+	uint32_t required_seen{};
+	for (size_t i = 0; i < count; i++) {
+		const auto& [name, value] = at(i);
+		const step here{path, name};
+		const key_rule* key = find_key(r, name);
+		if (!key) {
+			if (r.closed) {
+				out.push_back({path_of(&here), "unknown key"});
+			}
+			continue;
+		}
+		const size_t position = key - &code->keys[r.first_key];
+		if (big) {
+			scratch.seen[first_word + position / 64] |= uint64_t{1} << position % 64;
+		}
+		else {
+			seen_small |= uint64_t{1} << position;
+		}
+		required_seen += key->required;
+		check(code->rules[key->rule], value, &here, out, scratch);
+	}
+	if (required_seen != r.required_count) {
+		for (uint32_t i = 0; i < r.key_count; i++) {
+			const key_rule& key = code->keys[r.first_key + i];
+			const bool seen = (big ? scratch.seen[first_word + i / 64] >> i % 64 : seen_small >> i) & 1;
+			if (key.required && !seen) {
+				const step missing{path, key.name};
+				out.push_back({path_of(&missing), "missing key"});
+			}
+		}
+	}
+	scratch.seen.resize(first_word);
+}
+
+bool henifig::compiled_schema::validate(const value_t& value, schema_violations& out) const {
+	validation_scratch scratch;
+	return validate(value, out, scratch);
+}
+
+bool henifig::compiled_schema::validate(const config_t& cfg, schema_violations& out) const {
+	validation_scratch scratch;
+	return validate(cfg, out, scratch);
+}
+
+bool henifig::compiled_schema::validate(const value_t& value, schema_violations& out, validation_scratch& scratch) const {
+	const size_t before = out.size();
+	check(code->rules[0], value, nullptr, out, scratch);
+	return out.size() == before;
+}
+
+bool henifig::compiled_schema::validate(const config_t& cfg, schema_violations& out, validation_scratch& scratch) const {
+	const size_t before = out.size();
+	const rule& root = code->rules[0];
+	if (root.type == unset && !root.integral && !root.numeric) {
+		return true;
+	}
+	if (root.type != map) {
+		const char* expected = root.integral ? "integer" : root.numeric ? "number" : detail::type_name(root.type);
+		out.push_back({"", std::string("expected ") + expected + ", got " + detail::type_name(map)});
+		return false;
+	}
+	const std::vector <std::string>& vars = cfg.get_vars();
+	check_map(root, vars.size(), [&vars, &cfg](const size_t& i) {
+		return std::pair <std::string_view, const value_t&>(vars[i], cfg.get_value(i));
+	}, nullptr, out, scratch);
+	return out.size() == before;
+}
+
+henifig::schema_violations henifig::compiled_schema::validate(const value_t& value) const {
+	schema_violations res;
+	validate(value, res);
+	return res;
+}
+
+henifig::schema_violations henifig::compiled_schema::validate(const config_t& cfg) const {
+	schema_violations res;
+	validate(cfg, res);
+	return res;
+}
@@ -0,0 +1,542 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <system_error>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "henifig/exception.hpp"
+#include "henifig/shared.hpp"
+
+namespace {
+	constexpr char image_magic[8] = {'H', 'E', 'N', 'I', 'F', 'I', 'G', '\0'};
+	constexpr char control_magic[8] = {'H', 'E', 'N', 'I', 'F', 'I', 'G', 'C'};
+	constexpr uint32_t image_format = 1;
+	constexpr uint64_t index_threshold = 8;
+
+	/**
+	 * @brief The segment a named config is published under, telling which generation is the current one.
+	 */
+	struct control_block {
+		char magic[8];
+		// 0 until the first publication.
+		std::atomic <uint64_t> current;
+		// The last generation handed out to a publisher.
+		std::atomic <uint64_t> next;
+	};
+
+	static_assert(std::atomic <uint64_t>::is_always_lock_free, "The generations are shared between processes, their atomics can't take locks.");
+
+	/**
+	 * @brief Lays out the values breadth first, for the items of each container to be next to each other.
+	 */
+	class image_writer {
+		struct pending {
+			const henifig::value_t* value;
+			uint64_t node;
+		};
+		std::vector <henifig::shared_node> nodes;
+		std::vector <uint64_t> sorted;
+		std::string chars;
+		// Keys and strings are written once; the views are of the config, which outlives the writer.
+		std::unordered_map <std::string_view, uint64_t> written;
+		std::vector <pending> queue;
+
+		uint64_t add_chars(const std::string_view text) {
+			const auto [found, added] = written.try_emplace(text, chars.size());
+			if (added) {
+				chars += text;
+			}
+			return found->second;
+		}
+		void set_key(const uint64_t& node, const std::string_view key) {
+			nodes[node].key_first = add_chars(key);
+			nodes[node].key_size = static_cast <uint32_t>(key.size());
+		}
+		void fill(const uint64_t& node, const henifig::value_t& value) {
+			nodes[node].type = static_cast <uint8_t>(value.index());
+			switch (value.index()) {
+				case henifig::string: {
+					const std::string_view text = value.get <std::string_view>();
+					nodes[node].first = add_chars(text);
+					nodes[node].size = text.size();
+					break;
+				}
+				case henifig::character: {
+					nodes[node].bits = static_cast <unsigned char>(value.get <char>());
+					break;
+				}
+				case henifig::floating: {
+					const double x = value.get <double>();
+					std::memcpy(&nodes[node].bits, &x, sizeof(x));
+					break;
+				}
+				case henifig::ulonglong: {
+					nodes[node].bits = value.get <unsigned long long>();
+					break;
+				}
+				case henifig::longlong: {
+					nodes[node].bits = static_cast <uint64_t>(value.get <long long>());
+					break;
+				}
+				case henifig::boolean: {
+					nodes[node].bits = value.get <bool>();
+					break;
+				}
+				case henifig::array:
+				case henifig::map: {
+					queue.push_back({&value, node});
+					break;
+				}
+				default: {
+				}
+			}
+		}
+		template <typename T>
+		void add_packed(const henifig::packed_array& packed, const henifig::data_types& type) {
+			for (const T x : packed.get <T>()) {
+				henifig::shared_node& item = nodes.emplace_back();
+				item.type = type;
+				if constexpr (std::is_same_v <T, double>) {
+					std::memcpy(&item.bits, &x, sizeof(x));
+				}
+				else {
+					item.bits = static_cast <uint64_t>(x);
+				}
+			}
+		}
+		void index_map(const uint64_t& node) {
+			const uint64_t first = nodes[node].first, size = nodes[node].size;
+			if (size <= index_threshold) {
+				return;
+			}
+			nodes[node].index = sorted.size();
+			for (uint64_t i = first; i < first + size; i++) {
+				sorted.push_back(i);
+			}
+			std::sort(sorted.end() - static_cast <std::ptrdiff_t>(size), sorted.end(), [this](const uint64_t& a, const uint64_t& b) {
+				return chars.compare(nodes[a].key_first, nodes[a].key_size, chars, nodes[b].key_first, nodes[b].key_size) < 0;
+			});
+		}
+		// Taken by value, the queue grows while the container is expanded.
+		void expand(const pending container) {
+			const uint64_t first = nodes.size();
+			if (const auto* arr = std::get_if <henifig::array_t>(&container.value->value)) {
+				const henifig::packed_array& packed = arr->packed();
+				switch (packed.type()) {
+					case henifig::floating: {
+						add_packed <double>(packed, henifig::floating);
+						break;
+					}
+					case henifig::ulonglong: {
+						add_packed <unsigned long long>(packed, henifig::ulonglong);
+						break;
+					}
+					case henifig::longlong: {
+						add_packed <long long>(packed, henifig::longlong);
+						break;
+					}
+					case henifig::boolean: {
+						add_packed <bool>(packed, henifig::boolean);
+						break;
+					}
+					default: {
+						const henifig::value_array& items = arr->get();
+						nodes.resize(first + items.size());
+						for (size_t i = 0; i < items.size(); i++) {
+							fill(first + i, items[i]);
+						}
+					}
+				}
+				nodes[container.node].first = first;
+				nodes[container.node].size = nodes.size() - first;
+				return;
+			}
+			const henifig::value_map& items = container.value->get <henifig::value_map>();
+			nodes.resize(first + items.size());
+			uint64_t at = first;
+			for (const auto& [key, item] : items) {
+				set_key(at, key.view());
+				fill(at++, item);
+			}
+			nodes[container.node].first = first;
+			nodes[container.node].size = items.size();
+			index_map(container.node);
+		}
+	public:
+		std::vector <unsigned char> write(const henifig::config_t& cfg, const uint64_t& generation) {
+			// The variables make the root map.
+			const std::vector <std::string>& vars = cfg.get_vars();
+			nodes.resize(1 + vars.size());
+			nodes[0].type = henifig::map;
+			nodes[0].first = 1;
+			nodes[0].size = vars.size();
+			for (size_t i = 0; i < vars.size(); i++) {
+				set_key(1 + i, vars[i]);
+				fill(1 + i, cfg.get_value(i));
+			}
+			index_map(0);
+			for (size_t i = 0; i < queue.size(); i++) {
+				expand(queue[i]);
+			}
+
+			henifig::shared_header header;
+			std::memcpy(header.magic, image_magic, sizeof(image_magic));
+			header.format = image_format;
+			header.node_size = sizeof(henifig::shared_node);
+			header.generation = generation;
+			header.nodes = sizeof(header);
+			header.node_count = nodes.size();
+			header.index = header.nodes + nodes.size() * sizeof(henifig::shared_node);
+			header.index_count = sorted.size();
+			header.chars = header.index + sorted.size() * sizeof(uint64_t);
+			header.chars_size = chars.size();
+			header.size = header.chars + chars.size();
+			std::vector <unsigned char> res(header.size);
+			std::memcpy(res.data(), &header, sizeof(header));
+			std::memcpy(res.data() + header.nodes, nodes.data(), nodes.size() * sizeof(henifig::shared_node));
+			std::memcpy(res.data() + header.index, sorted.data(), sorted.size() * sizeof(uint64_t));
+			std::memcpy(res.data() + header.chars, chars.data(), chars.size());
+			return res;
+		}
+	};
+
+	[[noreturn]] void fail(const char* what) {
+		throw std::system_error(errno, std::generic_category(), what);
+	}
+
+	/**
+	 * @brief Map a whole file read-only, unmapping it once the last copy of the result is gone.
+	 */
+	std::shared_ptr <const void> map_file(const int fd, size_t& length) {
+		struct stat info{};
+		if (fstat(fd, &info) != 0) {
+			fail("fstat");
+		}
+		length = static_cast <size_t>(info.st_size);
+		if (!length) {
+			throw henifig::retrieval_exception("the shared config is empty");
+		}
+		void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+		if (address == MAP_FAILED) {
+			fail("mmap");
+		}
+		return {address, [length](const void* x) {
+			munmap(const_cast <void*>(x), length);
+		}};
+	}
+
+	void write_all(const int fd, const std::vector <unsigned char>& image) {
+		if (ftruncate(fd, static_cast <off_t>(image.size())) != 0) {
+			fail("ftruncate");
+		}
+		for (size_t written = 0; written < image.size();) {
+			const ssize_t res = pwrite(fd, image.data() + written, image.size() - written, static_cast <off_t>(written));
+			if (res < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				fail("pwrite");
+			}
+			written += static_cast <size_t>(res);
+		}
+	}
+
+	std::string segment_name(const std::string_view name, const uint64_t& generation) {
+		return std::string(name) + '.' + std::to_string(generation);
+	}
+
+	/**
+	 * @brief Map the control segment of a named config, creating it if asked to.
+	 */
+	std::shared_ptr <const void> map_control(const std::string_view name, const bool& create) {
+		const std::string path(name);
+		const int fd = shm_open(path.c_str(), create ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+		if (fd < 0) {
+			fail("shm_open");
+		}
+		struct stat info{};
+		if (fstat(fd, &info) != 0 || (create && static_cast <size_t>(info.st_size) < sizeof(control_block) &&
+			ftruncate(fd, sizeof(control_block)) != 0)) {
+			const int error = errno;
+			close(fd);
+			errno = error;
+			fail("ftruncate");
+		}
+		if (!create && static_cast <size_t>(info.st_size) < sizeof(control_block)) {
+			close(fd);
+			throw henifig::retrieval_exception("the shared config isn't published yet");
+		}
+		void* address = mmap(nullptr, sizeof(control_block), create ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (address == MAP_FAILED) {
+			fail("mmap");
+		}
+		auto* control = static_cast <control_block*>(address);
+		if (create) {
+			std::memcpy(control->magic, control_magic, sizeof(control_magic));
+		}
+		else if (std::memcmp(control->magic, control_magic, sizeof(control_magic)) != 0) {
+			munmap(address, sizeof(control_block));
+			throw henifig::retrieval_exception("not a shared config");
+		}
+		return {address, [](const void* x) {
+			munmap(const_cast <void*>(x), sizeof(control_block));
+		}};
+	}
+
+	control_block& control_of(const std::shared_ptr <const void>& control) {
+		return *static_cast <control_block*>(const_cast <void*>(control.get()));
+	}
+}
+
+henifig::shared_value::shared_value(const shared_node* nodes, const uint64_t* sorted, const char* chars, const uint64_t& at) :
+nodes(nodes), sorted(sorted), chars(chars), at(at) {}
+
+uint64_t henifig::shared_value::find_index(const std::string_view key) const {
+	const shared_node& map_node = node();
+	if (map_node.type != map) {
+		return NPOS;
+	}
+	const auto key_of = [this](const uint64_t& i) {
+		return std::string_view(chars + nodes[i].key_first, nodes[i].key_size);
+	};
+	if (map_node.index == NPOS) {
+		for (uint64_t i = map_node.first; i < map_node.first + map_node.size; i++) {
+			if (key_of(i) == key) {
+				return i;
+			}
+		}
+		return NPOS;
+	}
+	const uint64_t* begin = sorted + map_node.index;
+	const uint64_t* end = begin + map_node.size;
+	const uint64_t* found = std::lower_bound(begin, end, key, [&key_of](const uint64_t& i, const std::string_view x) {
+		return key_of(i) < x;
+	});
+	return found != end && key_of(*found) == key ? *found : NPOS;
+}
+
+henifig::shared_value henifig::shared_value::operator [](const std::string_view key) const {
+	const uint64_t res = find_index(key);
+	if (res == NPOS) {
+		throw std::out_of_range("shared_value::operator []");
+	}
+	return {nodes, sorted, chars, res};
+}
+
+std::vector <unsigned char> henifig::make_shared_image(const config_t& cfg, const uint64_t& generation) {
+	return image_writer().write(cfg, generation);
+}
+
+void henifig::shared_config::check_image(const size_t length) {
+	const auto* base = static_cast <const unsigned char*>(mapping.get());
+	const auto broken = []() {
+		return retrieval_exception("not a complete shared config image");
+	};
+	if (length < sizeof(shared_header) || reinterpret_cast <uintptr_t>(base) % alignof(shared_header)) {
+		throw broken();
+	}
+	header = reinterpret_cast <const shared_header*>(base);
+	const shared_header& h = *header;
+	const auto fits = [&h](const uint64_t& offset, const uint64_t& count, const uint64_t& size) {
+		return offset <= h.size && count <= (h.size - offset) / size;
+	};
+	if (std::memcmp(h.magic, image_magic, sizeof(image_magic)) != 0 || h.format != image_format ||
+		h.node_size != sizeof(shared_node) || h.size > length || h.nodes % 8 || h.index % 8 || !h.node_count ||
+		!fits(h.nodes, h.node_count, sizeof(shared_node)) || !fits(h.index, h.index_count, sizeof(uint64_t)) ||
+		!fits(h.chars, h.chars_size, 1)) {
+		throw broken();
+	}
+	nodes = reinterpret_cast <const shared_node*>(base + h.nodes);
+	sorted = reinterpret_cast <const uint64_t*>(base + h.index);
+	chars = reinterpret_cast <const char*>(base + h.chars);
+	if (nodes[0].type != map) {
+		throw broken();
+	}
+	// Everything the readers follow is checked once here, the items of a container always coming after it.
+	for (uint64_t i = 0; i < h.node_count; i++) {
+		const shared_node& x = nodes[i];
+		if (x.type > map || x.key_first > h.chars_size || x.key_size > h.chars_size - x.key_first) {
+			throw broken();
+		}
+		if (x.type == string && (x.first > h.chars_size || x.size > h.chars_size - x.first)) {
+			throw broken();
+		}
+		if (x.type != array && x.type != map) {
+			continue;
+		}
+		if (x.first <= i || x.first > h.node_count || x.size > h.node_count - x.first) {
+			throw broken();
+		}
+		if (x.index == NPOS) {
+			continue;
+		}
+		if (x.type != map || x.index > h.index_count || x.size > h.index_count - x.index) {
+			throw broken();
+		}
+		for (uint64_t j = x.index; j < x.index + x.size; j++) {
+			if (sorted[j] < x.first || sorted[j] >= x.first + x.size) {
+				throw broken();
+			}
+		}
+	}
+}
+
+henifig::shared_config henifig::shared_config::view(const void* data, const size_t length) {
+	shared_config res;
+	res.mapping = std::shared_ptr <const void>(data, [](const void*) {});
+	res.check_image(length);
+	return res;
+}
+
+henifig::shared_config henifig::shared_config::attach(const int fd) {
+	shared_config res;
+	size_t length{};
+	res.mapping = map_file(fd, length);
+	res.check_image(length);
+	return res;
+}
+
+henifig::shared_config henifig::shared_config::attach(const std::string_view name) {
+	std::shared_ptr <const void> control = map_control(name, false);
+	const control_block& block = control_of(control);
+	// The generation read may get replaced and unlinked before its segment is opened, in which case the next one is.
+	for (;;) {
+		const uint64_t generation = block.current.load(std::memory_order_acquire);
+		if (!generation) {
+			throw retrieval_exception("the shared config isn't published yet");
+		}
+		const int fd = shm_open(segment_name(name, generation).c_str(), O_RDONLY, 0);
+		if (fd < 0) {
+			if (errno == ENOENT && block.current.load(std::memory_order_acquire) != generation) {
+				continue;
+			}
+			fail("shm_open");
+		}
+		shared_config res;
+		try {
+			res = attach(fd);
+		}
+		catch (...) {
+			close(fd);
+			throw;
+		}
+		close(fd);
+		res.control = std::move(control);
+		return res;
+	}
+}
+
+uint64_t henifig::shared_config::publish(const config_t& cfg, const std::string_view name) {
+	const std::shared_ptr <const void> control = map_control(name, true);
+	control_block& block = control_of(control);
+	const uint64_t generation = block.next.fetch_add(1, std::memory_order_relaxed) + 1;
+	const std::vector <unsigned char> image = make_shared_image(cfg, generation);
+	const std::string segment = segment_name(name, generation);
+	const int fd = shm_open(segment.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+	if (fd < 0) {
+		fail("shm_open");
+	}
+	try {
+		write_all(fd, image);
+	}
+	catch (...) {
+		close(fd);
+		shm_unlink(segment.c_str());
+		throw;
+	}
+	close(fd);
+	// Switch the readers over unless a later publication got there first, then drop whichever segment lost.
+	uint64_t current = block.current.load(std::memory_order_relaxed);
+	while (current < generation && !block.current.compare_exchange_weak(current, generation, std::memory_order_release, std::memory_order_relaxed)) {}
+	const uint64_t replaced = current < generation ? current : generation;
+	if (replaced) {
+		shm_unlink(segment_name(name, replaced).c_str());
+	}
+	return generation;
+}
+
+void henifig::shared_config::unpublish(const std::string_view name) {
+	const std::shared_ptr <const void> control = map_control(name, false);
+	const uint64_t current = control_of(control).current.load(std::memory_order_acquire);
+	if (current) {
+		shm_unlink(segment_name(name, current).c_str());
+	}
+	shm_unlink(std::string(name).c_str());
+}
+
+int henifig::shared_config::publish_memfd(const config_t& cfg) {
+#ifdef __linux__
+	const int fd = memfd_create("henifig", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (fd < 0) {
+		fail("memfd_create");
+	}
+	try {
+		write_all(fd, make_shared_image(cfg));
+		if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0) {
+			fail("fcntl");
+		}
+	}
+	catch (...) {
+		close(fd);
+		throw;
+	}
+	return fd;
+#else
+	(void)cfg;
+	errno = ENOSYS;
+	fail("memfd_create");
+#endif
+}
+
+uint64_t henifig::shared_config::generation() const {
+	return header ? header->generation : 0;
+}
+
+bool henifig::shared_config::outdated() const {
+	return control && control_of(control).current.load(std::memory_order_acquire) != header->generation;
+}
+
+size_t henifig::shared_config::size() const {
+	return header ? nodes[0].size : 0;
+}
+
+bool henifig::shared_config::contains(const std::string_view var) const {
+	return header && shared_value(nodes, sorted, chars, 0).contains(var);
+}
+
+henifig::shared_value henifig::shared_config::operator [](const std::string_view var) const {
+	if (!header) {
+		throw std::out_of_range("shared_config::operator []");
+	}
+	return shared_value(nodes, sorted, chars, 0)[var];
+}
+
+henifig::shared_value henifig::shared_config::get_value(const size_t& index) const {
+	if (!header) {
+		throw std::out_of_range("shared_config::get_value");
+	}
+	return shared_value(nodes, sorted, chars, 0)[index];
+}
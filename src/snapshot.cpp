@@ -0,0 +1,464 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+#include "henifig/snapshot.hpp"
+#include "henifig/exception.hpp"
+
+namespace henifig::detail {
+	template <typename K, typename V>
+	struct tree_node {
+		K key;
+		V value;
+		uint64_t priority{};
+		size_t size{};
+		tree_ptr <K, V> left, right;
+	};
+}
+
+namespace {
+	using henifig::detail::tree_node;
+	using henifig::detail::tree_ptr;
+
+	// The nodes form a treap whose priorities are hashes of the keys, which keeps it balanced in expectation.
+	uint64_t mix(uint64_t x) {
+		x += 0x9e3779b97f4a7c15;
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+		return x ^ (x >> 31);
+	}
+
+	template <typename K, typename V>
+	size_t size_of(const tree_ptr <K, V>& t) {
+		return t ? t->size : 0;
+	}
+
+	template <typename K, typename V>
+	tree_ptr <K, V> make_node(K key, V value, const uint64_t& priority, tree_ptr <K, V> left, tree_ptr <K, V> right) {
+		const size_t size = size_of(left) + size_of(right) + 1;
+		return std::make_shared <const tree_node <K, V>>(tree_node <K, V>{std::move(key), std::move(value), priority, size, std::move(left), std::move(right)});
+	}
+
+	template <typename K, typename V>
+	tree_ptr <K, V> relink(const tree_node <K, V>& t, tree_ptr <K, V> left, tree_ptr <K, V> right) {
+		return make_node(t.key, t.value, t.priority, std::move(left), std::move(right));
+	}
+
+	template <typename K, typename V, typename Q>
+	const tree_node <K, V>* find_node(const tree_ptr <K, V>& t, const Q& key) {
+		const tree_node <K, V>* node = t.get();
+		while (node) {
+			if (key < node->key) {
+				node = node->left.get();
+			}
+			else if (node->key < key) {
+				node = node->right.get();
+			}
+			else {
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	template <typename K, typename V>
+	const tree_node <K, V>* select_node(const tree_ptr <K, V>& t, size_t rank) {
+		const tree_node <K, V>* node = t.get();
+		while (node) {
+			const size_t left_size = size_of(node->left);
+			if (rank < left_size) {
+				node = node->left.get();
+			}
+			else if (rank == left_size) {
+				return node;
+			}
+			else {
+				rank -= left_size + 1;
+				node = node->right.get();
+			}
+		}
+		return nullptr;
+	}
+
+	template <typename K, typename V>
+	tree_ptr <K, V> assign(const tree_ptr <K, V>& t, const K& key, V value) {
+		if (!t) {
+			return make_node <K, V>(key, std::move(value), mix(std::hash <K>{}(key)), nullptr, nullptr);
+		}
+		if (key < t->key) {
+			tree_ptr <K, V> left = assign(t->left, key, std::move(value));
+			if (left->priority > t->priority) {
+				return relink(*left, left->left, relink(*t, left->right, t->right));
+			}
+			return relink(*t, std::move(left), t->right);
+		}
+		if (t->key < key) {
+			tree_ptr <K, V> right = assign(t->right, key, std::move(value));
+			if (right->priority > t->priority) {
+				return relink(*right, relink(*t, t->left, right->left), right->right);
+			}
+			return relink(*t, t->left, std::move(right));
+		}
+		return make_node(t->key, std::move(value), t->priority, t->left, t->right);
+	}
+
+	template <typename K, typename V>
+	tree_ptr <K, V> join(const tree_ptr <K, V>& a, const tree_ptr <K, V>& b) {
+		if (!a) {
+			return b;
+		}
+		if (!b) {
+			return a;
+		}
+		if (a->priority > b->priority) {
+			return relink(*a, a->left, join(a->right, b));
+		}
+		return relink(*b, join(a, b->left), b->right);
+	}
+
+	template <typename K, typename V>
+	tree_ptr <K, V> remove(const tree_ptr <K, V>& t, const K& key) {
+		if (!t) {
+			return t;
+		}
+		if (key < t->key) {
+			return relink(*t, remove(t->left, key), t->right);
+		}
+		if (t->key < key) {
+			return relink(*t, t->left, remove(t->right, key));
+		}
+		return join(t->left, t->right);
+	}
+
+	template <typename K, typename V, typename F>
+	void for_each_node(const tree_ptr <K, V>& t, const F& f) {
+		if (!t) {
+			return;
+		}
+		for_each_node(t->left, f);
+		f(*t);
+		for_each_node(t->right, f);
+	}
+
+	const henifig::snapshot_value* map_find(const henifig::snapshot_map& m, const std::string_view key) {
+		const auto* id = find_node(m.ids, key);
+		return id ? &find_node(m.entries, id->value)->value.second : nullptr;
+	}
+
+	henifig::snapshot_map map_set(henifig::snapshot_map m, const std::string_view key, const henifig::snapshot_value& x) {
+		if (const auto* id = find_node(m.ids, key)) {
+			m.entries = assign(m.entries, id->value, std::pair {std::string(key), x});
+			return m;
+		}
+		m.ids = assign(m.ids, std::string(key), m.next_id);
+		m.entries = assign(m.entries, m.next_id, std::pair {std::string(key), x});
+		++m.next_id;
+		return m;
+	}
+
+	henifig::snapshot_array array_set(henifig::snapshot_array a, const size_t& index, const henifig::snapshot_value& x) {
+		const auto* item = select_node(a.items, index);
+		if (!item) {
+			throw henifig::retrieval_exception("The index " + std::to_string(index) + " is out of range.");
+		}
+		a.items = assign(a.items, item->key, x);
+		return a;
+	}
+
+	[[noreturn]] void no_key(const std::string_view key) {
+		throw henifig::retrieval_exception("The key `" + std::string(key) + "` does not exist.");
+	}
+
+	const henifig::snapshot_value* child(const henifig::snapshot_value& x, const henifig::path_item& item) {
+		if (item.index != henifig::NPOS) {
+			const auto* arr = std::get_if <henifig::snapshot_array>(&x.value);
+			const auto* node = arr ? select_node(arr->items, item.index) : nullptr;
+			return node ? &node->value : nullptr;
+		}
+		const auto* m = std::get_if <henifig::snapshot_map>(&x.value);
+		return m ? map_find(*m, item.key) : nullptr;
+	}
+
+	/**
+	 * @brief Put a new value at the item of a container, adding the key if it's a map.
+	 */
+	henifig::snapshot_value with_child(const henifig::snapshot_value& x, const henifig::path_item& item, const henifig::snapshot_value& new_child) {
+		if (item.index != henifig::NPOS) {
+			if (x.index() != henifig::array) {
+				throw henifig::retrieval_exception("An index was given for something that isn't an array.");
+			}
+			return array_set(std::get <henifig::snapshot_array>(x.value), item.index, new_child);
+		}
+		if (x.index() != henifig::map) {
+			throw henifig::retrieval_exception("The key `" + std::string(item.key) + "` was given for something that isn't a map.");
+		}
+		return map_set(std::get <henifig::snapshot_map>(x.value), item.key, new_child);
+	}
+
+	/**
+	 * @brief Rebuild the containers on the path with f applied to what the path leads to, sharing everything else.
+	 */
+	template <typename F>
+	henifig::snapshot_value modify(const henifig::snapshot_value& x, const henifig::path_item* it, const henifig::path_item* end, const F& f) {
+		if (it == end) {
+			return f(x);
+		}
+		const henifig::snapshot_value* next = child(x, *it);
+		if (!next) {
+			if (it->index != henifig::NPOS) {
+				throw henifig::retrieval_exception("The index " + std::to_string(it->index) + " is out of range.");
+			}
+			no_key(it->key);
+		}
+		return with_child(x, *it, modify(*next, it + 1, end, f));
+	}
+}
+
+henifig::snapshot_value::snapshot_value(const declaration_t x) : value(x) {}
+
+henifig::snapshot_value::snapshot_value(const char* x) : value(std::make_shared <const std::string>(x)) {}
+
+henifig::snapshot_value::snapshot_value(const std::string_view x) : value(std::make_shared <const std::string>(x)) {}
+
+henifig::snapshot_value::snapshot_value(const std::string& x) : value(std::make_shared <const std::string>(x)) {}
+
+henifig::snapshot_value::snapshot_value(const char x) : value(x) {}
+
+henifig::snapshot_value::snapshot_value(const double x) : value(x) {}
+
+henifig::snapshot_value::snapshot_value(const bool x) : value(x) {}
+
+henifig::snapshot_value::snapshot_value(snapshot_array x) : value(std::move(x)) {}
+
+henifig::snapshot_value::snapshot_value(snapshot_map x) : value(std::move(x)) {}
+
+size_t henifig::snapshot_value::index() const {
+	return value.index();
+}
+
+size_t henifig::snapshot_value::size() const {
+	if (const auto* arr = std::get_if <snapshot_array>(&value)) {
+		return size_of(arr->items);
+	}
+	return size_of(std::get <snapshot_map>(value).entries);
+}
+
+bool henifig::snapshot_value::contains(const std::string_view key) const {
+	const auto* m = std::get_if <snapshot_map>(&value);
+	return m && map_find(*m, key);
+}
+
+const henifig::snapshot_value& henifig::snapshot_value::operator [](const size_t& index) const {
+	const auto* node = select_node(std::get <snapshot_array>(value).items, index);
+	if (!node) {
+		throw retrieval_exception("The index " + std::to_string(index) + " is out of range.");
+	}
+	return node->value;
+}
+
+const henifig::snapshot_value& henifig::snapshot_value::operator [](const std::string_view key) const {
+	const snapshot_value* found = map_find(std::get <snapshot_map>(value), key);
+	if (!found) {
+		no_key(key);
+	}
+	return *found;
+}
+
+std::vector <std::string_view> henifig::snapshot_value::keys() const {
+	const snapshot_map& m = std::get <snapshot_map>(value);
+	std::vector <std::string_view> res;
+	res.reserve(size_of(m.entries));
+	for_each_node(m.entries, [&res](const auto& node) {
+		res.emplace_back(node.value.first);
+	});
+	return res;
+}
+
+henifig::snapshot_t::snapshot_t(snapshot_value root) : root(std::move(root)) {}
+
+henifig::snapshot_value henifig::snapshot_t::from_value(const value_t& x) {
+	switch (x.index()) {
+		case string: {
+			return x.get <std::string_view>();
+		}
+		case array: {
+			snapshot_array res;
+			const array_t& arr = std::get <array_t>(x.value);
+			for (size_t i = 0; i < arr.size(); i++) {
+				res.items = assign(res.items, res.next_id++, from_value(arr.packed().type() != unset ? arr.packed().at(i) : arr.get()[i]));
+			}
+			return res;
+		}
+		case map: {
+			snapshot_map res;
+			for (const auto& [key, item] : x.get <value_map>()) {
+				res = map_set(std::move(res), key.view(), from_value(item));
+			}
+			return res;
+		}
+		default: {
+			snapshot_value res;
+			std::visit([&res](const auto& y) {
+				using T = std::decay_t <decltype(y)>;
+				if constexpr (!std::is_same_v <T, istring> && !std::is_same_v <T, array_t> && !std::is_same_v <T, map_t>) {
+					res.value = y;
+				}
+			}, x.value);
+			return res;
+		}
+	}
+}
+
+henifig::value_t henifig::snapshot_t::to_value(config_t& res, const snapshot_value& x) {
+	switch (x.index()) {
+		case string: {
+			return res.strings().intern(x.get <std::string_view>());
+		}
+		case array: {
+			array_data& arr = res.new_array();
+			arr.items.reserve(x.size());
+			for_each_node(std::get <snapshot_array>(x.value).items, [&res, &arr](const auto& node) {
+				arr.items.push_back(to_value(res, node.value));
+			});
+			return array_t{&arr};
+		}
+		case map: {
+			value_map& m = res.new_map();
+			m.reserve(x.size());
+			for_each_node(std::get <snapshot_map>(x.value).entries, [&res, &m](const auto& node) {
+				m[res.strings().intern(node.value.first)] = to_value(res, node.value.second);
+			});
+			return map_t{&m};
+		}
+		default: {
+			value_t res_value;
+			std::visit([&res_value](const auto& y) {
+				using T = std::decay_t <decltype(y)>;
+				if constexpr (!std::is_same_v <T, std::shared_ptr <const std::string>> && !std::is_same_v <T, snapshot_array> && !std::is_same_v <T, snapshot_map>) {
+					res_value.value = y;
+				}
+			}, x.value);
+			return res_value;
+		}
+	}
+}
+
+henifig::snapshot_t::snapshot_t(const config_t& cfg) {
+	snapshot_map vars;
+	for (size_t i = 0; i < cfg.vars.size(); i++) {
+		vars = map_set(std::move(vars), cfg.vars[i], from_value(cfg.values[i]));
+	}
+	root = std::move(vars);
+}
+
+size_t henifig::snapshot_t::size() const {
+	return root.size();
+}
+
+bool henifig::snapshot_t::contains(const std::string_view var) const {
+	return root.contains(var);
+}
+
+const henifig::snapshot_value& henifig::snapshot_t::operator [](const std::string_view var) const {
+	const snapshot_value* found = map_find(std::get <snapshot_map>(root.value), var);
+	if (!found) {
+		throw retrieval_exception("The variable `" + std::string(var) + "` does not exist.");
+	}
+	return *found;
+}
+
+std::vector <std::string_view> henifig::snapshot_t::get_vars() const {
+	return root.keys();
+}
+
+const henifig::snapshot_value* henifig::snapshot_t::find(const snapshot_path path) const {
+	const snapshot_value* res = &root;
+	for (const path_item& item : path) {
+		if (!(res = child(*res, item))) {
+			return nullptr;
+		}
+	}
+	return res;
+}
+
+henifig::snapshot_t henifig::snapshot_t::set(const snapshot_path path, const snapshot_value& x) const {
+	if (path.size() == 0) {
+		throw retrieval_exception("An empty path was given.");
+	}
+	const path_item& last = *(path.end() - 1);
+	return snapshot_t(modify(root, path.begin(), path.end() - 1, [&last, &x](const snapshot_value& parent) {
+		return with_child(parent, last, x);
+	}));
+}
+
+henifig::snapshot_t henifig::snapshot_t::erase(const snapshot_path path) const {
+	if (path.size() == 0) {
+		throw retrieval_exception("An empty path was given.");
+	}
+	const path_item& last = *(path.end() - 1);
+	return snapshot_t(modify(root, path.begin(), path.end() - 1, [&last](const snapshot_value& parent) -> snapshot_value {
+		if (!child(parent, last)) {
+			if (last.index != NPOS) {
+				throw retrieval_exception("The index " + std::to_string(last.index) + " is out of range.");
+			}
+			no_key(last.key);
+		}
+		if (last.index != NPOS) {
+			snapshot_array arr = std::get <snapshot_array>(parent.value);
+			arr.items = remove(arr.items, select_node(arr.items, last.index)->key);
+			return arr;
+		}
+		snapshot_map m = std::get <snapshot_map>(parent.value);
+		const uint64_t id = find_node(m.ids, last.key)->value;
+		m.ids = remove(m.ids, std::string(last.key));
+		m.entries = remove(m.entries, id);
+		return m;
+	}));
+}
+
+henifig::snapshot_t henifig::snapshot_t::push_back(const snapshot_path path, const snapshot_value& x) const {
+	return snapshot_t(modify(root, path.begin(), path.end(), [&x](const snapshot_value& target) -> snapshot_value {
+		if (target.index() != array) {
+			throw retrieval_exception("Can't push an item into something that isn't an array.");
+		}
+		snapshot_array arr = std::get <snapshot_array>(target.value);
+		arr.items = assign(arr.items, arr.next_id++, x);
+		return arr;
+	}));
+}
+
+henifig::snapshot_t henifig::snapshot_t::insert(const snapshot_path path, const std::string_view key, const snapshot_value& x) const {
+	return snapshot_t(modify(root, path.begin(), path.end(), [key, &x](const snapshot_value& target) -> snapshot_value {
+		if (target.index() != map) {
+			throw retrieval_exception("Can't insert a key into something that isn't a map.");
+		}
+		if (target.contains(key)) {
+			throw retrieval_exception("The key `" + std::string(key) + "` already exists.");
+		}
+		return map_set(std::get <snapshot_map>(target.value), key, x);
+	}));
+}
+
+henifig::config_t henifig::snapshot_t::to_config() const {
+	config_t res;
+	res.strings();
+	for_each_node(std::get <snapshot_map>(root.value).entries, [&res](const auto& node) {
+		res.var_nums[node.value.first] = res.vars.size();
+		res.vars.push_back(node.value.first);
+		res.values.push_back(to_value(res, node.value.second));
+	});
+	return res;
+}
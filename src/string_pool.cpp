@@ -0,0 +1,152 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+#include "henifig/string_pool.hpp"
+
+const henifig::istring::entry henifig::istring::empty("", nullptr, false);
+
+henifig::istring::entry::entry(const std::string_view text, const string_pool* pool, const bool& borrowed) :
+text(text), pool(pool), borrowed(borrowed) {
+	if (!borrowed) {
+		str = text;
+		this->text = str;
+	}
+}
+
+henifig::istring::istring(const entry* node) : node(node) {}
+
+henifig::istring::operator const std::string&() const {
+	return get();
+}
+
+henifig::istring::operator std::string_view() const {
+	return node->text;
+}
+
+const std::string& henifig::istring::get() const {
+	if (node->borrowed) {
+		std::call_once(node->copied, [this]() {
+			node->str = node->text;
+		});
+	}
+	return node->str;
+}
+
+std::string_view henifig::istring::view() const {
+	return node->text;
+}
+
+const char* henifig::istring::data() const {
+	return get().data();
+}
+
+size_t henifig::istring::size() const {
+	return node->text.size();
+}
+
+const henifig::string_pool* henifig::istring::owner() const {
+	return node->pool;
+}
+
+bool henifig::istring::operator ==(const istring& other) const {
+	if (node->pool && node->pool == other.node->pool) {
+		return node == other.node;
+	}
+	return node->text == other.node->text;
+}
+
+bool henifig::istring::operator !=(const istring& other) const {
+	return !(*this == other);
+}
+
+bool henifig::istring::operator ==(const std::string_view other) const {
+	return node->text == other;
+}
+
+bool henifig::istring::operator !=(const std::string_view other) const {
+	return node->text != other;
+}
+
+bool henifig::istring::operator <(const istring& other) const {
+	return node != other.node && node->text < other.node->text;
+}
+
+bool henifig::istring::operator <(const std::string_view other) const {
+	return node->text < other;
+}
+
+bool henifig::operator <(const std::string_view lhs, const istring& rhs) {
+	return lhs < rhs.node->text;
+}
+
+std::ostream& henifig::operator <<(std::ostream& os, const istring& str) {
+	return os << str.get();
+}
+
+henifig::istring henifig::string_pool::intern(const std::string_view str) {
+	std::lock_guard lock(mutex);
+	requested += str.size();
+	if (const auto found = index.find(str); found != index.end()) {
+		return istring(found->second);
+	}
+	const istring::entry& stored = strings.emplace_back(str, this, false);
+	stored_bytes += stored.text.size();
+	index.emplace(stored.text, &stored);
+	return istring(&stored);
+}
+
+void henifig::string_pool::clear() {
+	std::lock_guard lock(mutex);
+	index.clear();
+	strings.clear();
+	stored_bytes = 0;
+	requested = 0;
+}
+
+size_t henifig::string_pool::size() const {
+	std::lock_guard lock(mutex);
+	return strings.size();
+}
+
+size_t henifig::string_pool::bytes() const {
+	std::lock_guard lock(mutex);
+	return stored_bytes;
+}
+
+size_t henifig::string_pool::requested_bytes() const {
+	std::lock_guard lock(mutex);
+	return requested;
+}
+
+const std::shared_ptr <henifig::string_pool>& henifig::string_pool::global() {
+	static const std::shared_ptr <string_pool> pool = std::make_shared <string_pool>();
+	return pool;
+}
+
+henifig::istring henifig::string_views::view(const std::string_view str) {
+	if (!strings) {
+		strings = std::make_unique <std::deque <istring::entry>>();
+	}
+	return istring(&strings->emplace_back(str, nullptr, true));
+}
+
+void henifig::string_views::clear() {
+	strings.reset();
+}
+
+size_t henifig::string_views::size() const {
+	return strings ? strings->size() : 0;
+}
@@ -14,16 +14,17 @@
  * limitations under the License.
 ***************************************************************************/
 
+#include <algorithm>
+#include <new>
 #include <utility>
 
 #include "henifig/types.hpp"
 
-henifig::config_t::brace_t::brace_t(const size_t& num, const size_t& i) : num(num), i(i) {}
-
-henifig::parse_report::parse_report(const error_codes& error_code, const std::string_view error_filename) : error_code(error_code), error_filename(error_filename) {}
+henifig::parse_report::parse_report(const error_codes& error_code, const std::string_view error_filename) : parse_report(error_code, 0, 0, error_filename) {}
 
 henifig::parse_report::parse_report(const error_codes& error_code, const size_t& error_line, const size_t& error_index, const std::string_view error_filename, const std::string_view error_details) :
-error_code(error_code), error_line(error_line), error_index(error_index), error_filename(error_filename), error_details(error_details) {}
+error_code(error_code), error_line(error_line), error_index(error_index),
+text(error_filename.empty() && error_details.empty() ? nullptr : std::make_shared <const text_t>(text_t{std::string(error_filename), std::string(error_details)})) {}
 
 bool henifig::parse_report::is_error() const noexcept {
 	return error_code != OK;
@@ -46,11 +47,11 @@ size_t henifig::parse_report::get_error_index() const noexcept {
 }
 
 std::string_view henifig::parse_report::get_error_filename() const noexcept {
-	return error_filename;
+	return text ? std::string_view(text->filename) : std::string_view();
 }
 
 std::string_view henifig::parse_report::get_parse_error_details() const noexcept {
-	return error_details;
+	return text ? std::string_view(text->details) : std::string_view();
 }
 
 henifig::value_t::value_t(value_variant value) : value(std::move(value)) {}
@@ -63,20 +64,217 @@ henifig::value_t::operator const henifig::value_variant&() const {
 	return value;
 }
 
+henifig::data_types henifig::packed_array::type() const {
+	if (!count) {
+		return unset;
+	}
+	switch (items.index()) {
+		case 1: return floating;
+		case 2: return ulonglong;
+		case 3: return longlong;
+		case 4: return boolean;
+		default: return unset;
+	}
+}
+
+size_t henifig::packed_array::size() const {
+	return count;
+}
+
+void henifig::packed_array::shrink_to_fit() {
+	if (capacity == count) {
+		return;
+	}
+	std::visit([this](auto& storage) {
+		if constexpr (!std::is_same_v <std::decay_t <decltype(storage)>, std::monostate>) {
+			using T = typename std::decay_t <decltype(storage)>::element_type;
+			std::unique_ptr <T[]> fitted(count ? new T[count] : nullptr);
+			std::copy(storage.get(), storage.get() + count, fitted.get());
+			storage = std::move(fitted);
+		}
+	}, items);
+	capacity = count;
+}
+
+void henifig::packed_array::clear() {
+	count = 0;
+}
+
+henifig::value_t henifig::packed_array::at(const size_t& index) const {
+	switch (type()) {
+		case floating: return get <double>()[index];
+		case ulonglong: return get <unsigned long long>()[index];
+		case longlong: return get <long long>()[index];
+		case boolean: return get <bool>()[index];
+		default: return {};
+	}
+}
+
+const henifig::value_array& henifig::array_data::get() const {
+	if (packed.type() != unset) {
+		std::call_once(boxed, [this]() {
+			items.reserve(packed.size());
+			for (size_t i = 0; i < packed.size(); i++) {
+				items.push_back(packed.at(i));
+			}
+		});
+	}
+	return items;
+}
+
+void henifig::array_data::clear() {
+	items.clear();
+	packed.clear();
+	// A once_flag can't be reset, only made anew.
+	boxed.~once_flag();
+	new (&boxed) std::once_flag;
+}
+
 henifig::array_t::operator const value_array&() const {
-	return cfg->get_arr(index);
+	return data->get();
 }
 
 const std::vector <henifig::value_t>& henifig::array_t::get() const {
-	return cfg->get_arr(index);
+	return data->get();
+}
+
+const henifig::packed_array& henifig::array_t::packed() const {
+	return data->packed;
+}
+
+size_t henifig::array_t::size() const {
+	return data->packed.type() != unset ? data->packed.size() : data->items.size();
 }
 
 henifig::map_t::operator const value_map&() const {
-	return cfg->get_map(index);
+	return *items;
 }
 
 const henifig::value_map& henifig::map_t::get() const {
-	return cfg->get_map(index);
+	return *items;
+}
+
+template <typename K>
+size_t henifig::value_map::find_index(const K& key, const std::string_view view) const {
+	// Keys from the map's own pool are compared by pointer, anything else by content.
+	if (slots.empty()) {
+		for (size_t i = 0; i < entries.size(); i++) {
+			if (entries[i].first == key) {
+				return i;
+			}
+		}
+		return NPOS;
+	}
+	const size_t mask = slots.size() - 1;
+	for (size_t slot = std::hash <std::string_view>{}(view) & mask; slots[slot]; slot = (slot + 1) & mask) {
+		if (entries[slots[slot] - 1].first == key) {
+			return slots[slot] - 1;
+		}
+	}
+	return NPOS;
+}
+
+void henifig::value_map::index_entry(const size_t& entry) {
+	const size_t mask = slots.size() - 1;
+	size_t slot = std::hash <std::string_view>{}(entries[entry].first.view()) & mask;
+	while (slots[slot]) {
+		slot = (slot + 1) & mask;
+	}
+	slots[slot] = static_cast <uint32_t>(entry + 1);
+}
+
+void henifig::value_map::rehash(const size_t& slot_count) {
+	slots.assign(slot_count, 0);
+	for (size_t i = 0; i < entries.size(); i++) {
+		index_entry(i);
+	}
+}
+
+henifig::value_map::iterator henifig::value_map::begin() {
+	return entries.begin();
+}
+
+henifig::value_map::iterator henifig::value_map::end() {
+	return entries.end();
+}
+
+henifig::value_map::const_iterator henifig::value_map::begin() const {
+	return entries.begin();
+}
+
+henifig::value_map::const_iterator henifig::value_map::end() const {
+	return entries.end();
+}
+
+size_t henifig::value_map::size() const {
+	return entries.size();
+}
+
+bool henifig::value_map::empty() const {
+	return entries.empty();
+}
+
+henifig::value_map::iterator henifig::value_map::find(const std::string_view key) {
+	const size_t index = find_index(key, key);
+	return index == NPOS ? entries.end() : entries.begin() + index;
+}
+
+henifig::value_map::const_iterator henifig::value_map::find(const std::string_view key) const {
+	const size_t index = find_index(key, key);
+	return index == NPOS ? entries.end() : entries.begin() + index;
+}
+
+size_t henifig::value_map::count(const std::string_view key) const {
+	return find_index(key, key) != NPOS;
+}
+
+bool henifig::value_map::contains(const std::string_view key) const {
+	return find_index(key, key) != NPOS;
+}
+
+henifig::value_t& henifig::value_map::at(const std::string_view key) {
+	const size_t index = find_index(key, key);
+	if (index == NPOS) {
+		throw std::out_of_range("value_map::at");
+	}
+	return entries[index].second;
+}
+
+const henifig::value_t& henifig::value_map::at(const std::string_view key) const {
+	const size_t index = find_index(key, key);
+	if (index == NPOS) {
+		throw std::out_of_range("value_map::at");
+	}
+	return entries[index].second;
+}
+
+henifig::value_t& henifig::value_map::operator [](const istring& key) {
+	if (const size_t index = find_index(key, key.view()); index != NPOS) {
+		return entries[index].second;
+	}
+	entries.emplace_back(key, value_t{});
+	if (entries.size() > index_threshold) {
+		if (entries.size() * 2 > slots.size()) {
+			rehash(std::max(slots.size() * 2, index_threshold * 4));
+		}
+		else {
+			index_entry(entries.size() - 1);
+		}
+	}
+	return entries.back().second;
+}
+
+void henifig::value_map::reserve(const size_t& size) {
+	entries.reserve(size);
+}
+
+void henifig::value_map::shrink_to_fit() {
+	entries.shrink_to_fit();
+}
+
+void henifig::value_map::clear() {
+	entries.clear();
+	slots.clear();
 }
 
 bool henifig::value_t::isdef() const {
@@ -91,10 +289,86 @@ const henifig::value_t& henifig::value_t::operator[](const std::size_t& index) c
 	return get <value_array>()[index];
 }
 
+const henifig::value_t* henifig::value_t::find(const std::size_t& index) const {
+	const array_t* arr = std::get_if <array_t>(&value);
+	if (!arr || index >= arr->size()) {
+		return nullptr;
+	}
+	return &arr->get()[index];
+}
+
+const henifig::value_t* henifig::value_t::find(const std::string_view key) const {
+	const map_t* items = std::get_if <map_t>(&value);
+	if (!items) {
+		return nullptr;
+	}
+	const auto found = items->get().find(key);
+	return found != items->get().end() ? &found->second : nullptr;
+}
+
+namespace {
+	template <typename T>
+	void copy_packed(const henifig::packed_array& from, henifig::packed_array& to) {
+		const henifig::span <const T> items = from.get <T>();
+		std::copy(items.begin(), items.end(), to.assign <T>(items.size()));
+	}
+}
+
+henifig::value_t henifig::config_t::adopt(const value_t& x) {
+	switch (x.index()) {
+		case string: {
+			return strings().intern(x.get <std::string_view>());
+		}
+		case array: {
+			const array_t& from = std::get <array_t>(x.value);
+			array_data& copy = new_array();
+			switch (from.packed().type()) {
+				case floating: {
+					copy_packed <double>(from.packed(), copy.packed);
+					break;
+				}
+				case ulonglong: {
+					copy_packed <unsigned long long>(from.packed(), copy.packed);
+					break;
+				}
+				case longlong: {
+					copy_packed <long long>(from.packed(), copy.packed);
+					break;
+				}
+				case boolean: {
+					copy_packed <bool>(from.packed(), copy.packed);
+					break;
+				}
+				default: {
+					const value_array& items = from.get();
+					copy.items.reserve(items.size());
+					for (const value_t& item : items) {
+						copy.items.push_back(adopt(item));
+					}
+				}
+			}
+			return array_t{&copy};
+		}
+		case map: {
+			const value_map& from = x.get <value_map>();
+			value_map& copy = new_map();
+			copy.reserve(from.size());
+			for (const auto& [key, item] : from) {
+				copy[strings().intern(key.view())] = adopt(item);
+			}
+			return map_t{&copy};
+		}
+		default: {
+			return x;
+		}
+	}
+}
+
 henifig::config_t::operator value_map() const {
 	value_map res;
+	res.reserve(vars.size());
 	for (const std::string& x : vars) {
-		res[x] = operator[](x);
+		res[pool->intern(x)] = operator[](x);
 	}
 	return res;
 }
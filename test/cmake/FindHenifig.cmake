@@ -16,6 +16,13 @@ find_path(HENIFIG_INCLUDE_DIR NAMES henifig/henifig.hpp HINTS "../include")
 
 find_library(HENIFIG_LIBRARIES NAMES henifig "libhenifig" HINTS "../build")
 
+find_program(HENIFIG_GEN_EXECUTABLE NAMES henifig-gen HINTS "../build")
+
+find_file(HENIFIG_GENERATE_MODULE NAMES HenifigGenerate.cmake HINTS "${HENIFIG_INCLUDE_DIR}/../cmake" "../cmake")
+if (HENIFIG_GENERATE_MODULE)
+    include(${HENIFIG_GENERATE_MODULE})
+endif()
+
 include(FindPackageHandleStandardArgs)
 
 find_package_handle_standard_args(Henifig DEFAULT_MSG HENIFIG_INCLUDE_DIR HENIFIG_LIBRARIES)
@@ -14,10 +14,297 @@
  * limitations under the License.
 ***************************************************************************/
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <functional>
+#include <limits>
+#include <new>
+#include <optional>
+
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "henifig/henifig.hpp"
 #include "henifig/json.hpp"
+#ifdef HENIFIG_TEST_GENERATED
+#include "sample.hpp"
+#endif
+
+enum class mode {
+	fast,
+	safe,
+};
+
+HENIFIG_ENUM(mode, {"fast", mode::fast}, {"safe", mode::safe})
+
+struct server_cfg {
+	std::string host;
+	unsigned short port{};
+	mode run_mode{};
+	std::vector <std::string> tags;
+	int backlog{};
+};
+
+HENIFIG_FIELDS(server_cfg,
+	henifig::field("host", &server_cfg::host),
+	henifig::field("port", &server_cfg::port),
+	henifig::field("mode", &server_cfg::run_mode),
+	henifig::field("tags", &server_cfg::tags),
+	henifig::field("backlog", &server_cfg::backlog, 128)
+)
+
+struct service_cfg {
+	std::string name;
+	server_cfg server;
+	std::map <std::string, double> limits;
+	std::vector <int> ports;
+	std::optional <bool> verbose;
+	std::vector <bool> flags;
+};
+
+HENIFIG_FIELDS(service_cfg,
+	henifig::field("name", &service_cfg::name),
+	henifig::field("server", &service_cfg::server),
+	henifig::field("limits", &service_cfg::limits),
+	henifig::field("ports", &service_cfg::ports),
+	henifig::field("verbose", &service_cfg::verbose),
+	henifig::field("flags", &service_cfg::flags, std::vector <bool>{})
+)
+
+/**
+ * @brief Writes the events it gets down, e.g. "var(a) [ 1 ]".
+ */
+struct event_log final : henifig::sax_handler {
+	std::string log;
+	std::string_view input;
+	size_t views{};
+	henifig::error_codes on_var(const std::string_view name) override {
+		if (name == "forbidden") {
+			return henifig::REDECLARED_VAR;
+		}
+		log += "var(" + std::string(name) + ") ";
+		return henifig::OK;
+	}
+	henifig::error_codes on_key(const std::string_view key) override {
+		log += "key(" + std::string(key) + ") ";
+		return henifig::OK;
+	}
+	henifig::error_codes on_scalar(const henifig::scalar_t& x) override {
+		switch (x.index()) {
+			case henifig::declaration: {
+				log += "decl ";
+				break;
+			}
+			case henifig::string: {
+				const std::string_view str = std::get <std::string_view>(x);
+				views += str.data() >= input.data() && str.data() < input.data() + input.size();
+				log += '"' + std::string(str) + "\" ";
+				break;
+			}
+			case henifig::ulonglong: {
+				log += std::to_string(std::get <unsigned long long>(x)) + ' ';
+				break;
+			}
+			case henifig::boolean: {
+				log += std::get <bool>(x) ? "true " : "false ";
+				break;
+			}
+			default: {
+				log += "? ";
+			}
+		}
+		return henifig::OK;
+	}
+	henifig::error_codes on_array_begin() override {
+		log += "[ ";
+		return henifig::OK;
+	}
+	henifig::error_codes on_array_end() override {
+		log += "] ";
+		return henifig::OK;
+	}
+	henifig::error_codes on_map_begin() override {
+		log += "{ ";
+		return henifig::OK;
+	}
+	henifig::error_codes on_map_end() override {
+		log += "} ";
+		return henifig::OK;
+	}
+};
+
+/**
+ * @brief A shape of input meant to find anything slower than linear in the parser:
+ * head, then open and close repeated until the size is reached, then tail. A % in open is replaced by a counter.
+ */
+struct adversarial_input {
+	const char* name;
+	std::string_view head, open, close, tail;
+
+	[[nodiscard]] std::string make(const size_t& size) const {
+		std::string res(head);
+		size_t count = 0;
+		while (res.size() + count * close.size() < size) {
+			for (const char c : open) {
+				c == '%' ? res += std::to_string(count) : res += c;
+			}
+			++count;
+		}
+		for (size_t i = 0; i < count; i++) {
+			res += close;
+		}
+		return res += tail;
+	}
+};
+
+const adversarial_input adversarial_corpus[] = {
+	{"long string", "/a\\ | \"", "x", "", "\"\n"},
+	{"long name", "/a", "x", "", "\\ | 1\n"},
+	{"escape run", "/a\\ | \"", "\\\\\\\"\\n", "", "\"\n"},
+	{"deep arrays", "/a", "[", "]", "\\\n"},
+	{"deep maps", "/a{", "$\"k\" | {", "}", "}\\\n"},
+	{"block comment", "[#", "#[ ] # [ { \" comment ", "", "#]\n/a\\ | 1\n"},
+	{"line comments", "", "# [ { \" '\n", "", "/a\\ | 1\n"},
+	{"many vars", "", "/v%\\ | 1\n", "", ""},
+	{"wide array", "/a[", "1, ", "", "1]\\\n"},
+	{"wide map", "/a{", "$\"k%\" | 1, ", "", "$\"z\" | 1}\\\n"},
+	{"long number", "/a\\ | 1.", "5", "", "\n"},
+	{"blank run", "/a\\ |", " ", "", "1\n"},
+};
+
+/**
+ * @brief The best time out of a few parses of the content in seconds, or a negative number if it doesn't parse.
+ */
+double best_parse_time(const std::string& content) {
+	double res = -1;
+	for (size_t i = 0; i < 3; i++) {
+		henifig::config_t cfg;
+		const auto start = std::chrono::steady_clock::now();
+		const henifig::parse_report report = cfg.try_parse(content);
+		const double time = std::chrono::duration <double>(std::chrono::steady_clock::now() - start).count();
+		if (report.is_error()) {
+			std::cout << henifig::parse_exception(report).what() << '\n';
+			return -1;
+		}
+		res = res < 0 || time < res ? time : res;
+	}
+	return res;
+}
+
+constexpr std::string_view embedded_text = R"(# Built in, parsed while compiling.
+/name\ | "svc" " joined"
+/port\ | 8080
+/offset\ | -12; /ratio\ | -.25
+/verbose\ | true
+/separator\ | '\n'
+/debug\
+/ids[1, 2, [3, 4]]\
+/server{
+  $"host" | "localhost",
+  $"tags" | ["a", "b"], [# unused #]
+  $"backup"
+}\
+)";
+
+constexpr auto embedded = HENIFIG_STATIC(embedded_text);
+static_assert(embedded["port"].get <unsigned long long>() == 8080 && embedded["offset"].value_or(0) == -12);
+static_assert(embedded["name"].get <std::string_view>() == "svc joined");
+static_assert(embedded["server"]["tags"][1].get <std::string_view>() == "b" && embedded["server"]["backup"].isdef());
+
+// Read both while compiling and at runtime, for the two grammars not to drift apart.
+constexpr std::string_view grammar_text = R"(/a#b\ | 1
+/c#]\ | "hash"
+/list[# a comment right after the name
+  1, 2, [# and a block one #] 3]\
+/spaced name\ | 'x'
+/back\\slash\ | true
+/m{[# inside #] $"k" | { $"nested" | -.5 }, $"d" }\ # after it
+/joined\ | "a\"b" # between
+  "c\n"
+/decl\; /last\ | 18446744073709551615
+/long\ | 1.00000000000000000000001
+/tie\ | 9007199254740993.0; /above\ | 9007199254740993.00000000000000000001
+/huge\ | 179769313486231570814527423731704356798070567525844996598917476803157260780028538760589558632766878171540458953514382464234321326889464182768467546703537516986049910576551282076245490090389328944075868508455133942304583236903222948165808559332123348274797826204144723168738177180919299881250404026184124858368.0
+/tiny\ | -0.000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000005
+)";
+constexpr auto grammar = HENIFIG_STATIC(grammar_text);
+// Floats with more digits than a double holds are rounded to the nearest one, halfway going to the even one.
+static_assert(grammar["long"].get <double>() == 1 && grammar["tie"].get <double>() == 9007199254740992.0 &&
+grammar["above"].get <double>() == 9007199254740994.0 && grammar["tiny"].get <double>() == -std::numeric_limits <double>::denorm_min());
+
+// Writing a key through an iterator would leave the hash index of a map pointing at the old one.
+static_assert(std::is_const_v <decltype(std::declval <henifig::value_map::iterator>()->first)>);
+
+/**
+ * @brief Whether a value parsed while compiling is the same as one parsed at runtime.
+ */
+template <typename V>
+bool same_value(const V& x, const henifig::value_t& y) {
+	if (x.index() != y.index()) {
+		return false;
+	}
+	switch (x.index()) {
+		case henifig::string: {
+			return x.template get <std::string_view>() == y.get <std::string_view>();
+		}
+		case henifig::character: {
+			return x.template get <char>() == y.get <char>();
+		}
+		case henifig::floating: {
+			return x.template get <double>() == y.get <double>();
+		}
+		case henifig::ulonglong: {
+			return x.template get <unsigned long long>() == y.get <unsigned long long>();
+		}
+		case henifig::longlong: {
+			return x.template get <long long>() == y.get <long long>();
+		}
+		case henifig::boolean: {
+			return x.template get <bool>() == y.get <bool>();
+		}
+		case henifig::array: {
+			for (size_t i = 0; i < x.size(); i++) {
+				if (!y.find(i) || !same_value(x[i], *y.find(i))) {
+					return false;
+				}
+			}
+			return !y.find(x.size());
+		}
+		case henifig::map: {
+			for (size_t i = 0; i < x.size(); i++) {
+				if (!y.find(x[i].key()) || !same_value(x[i], *y.find(x[i].key()))) {
+					return false;
+				}
+			}
+			return x.size() == y.get <henifig::value_map>().size();
+		}
+		default: {
+			return true;
+		}
+	}
+}
+
+// Counts every allocation made by the tests, to check the ones which shouldn't make any.
+std::atomic <size_t> allocations{};
+
+void* operator new(const std::size_t size) {
+	++allocations;
+	if (void* res = std::malloc(size ? size : 1)) {
+		return res;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+	std::free(ptr);
+}
 
 int main(const int argc, const char** argv) {
 	if (argc > 2) {
@@ -173,6 +460,1164 @@ int main(const int argc, const char** argv) {
 				return false;
 			}
 		},
+		[]() -> bool {
+			try {
+				henifig::config_t bound;
+				bound << R"(/name\ | "svc"
+/server{
+  $"host" | "localhost",
+  $"port" | 8080,
+  $"mode" | "safe",
+  $"tags" | ["a", "b"]
+}\
+/limits{
+  $"cpu" | 1.5,
+  $"mem" | 512
+}\
+/ports[1, 2, 3]\
+/flags[true, false, true]\
+)";
+				const service_cfg svc = henifig::bind <service_cfg>(bound);
+				if (svc.name != "svc" || svc.server.host != "localhost" || svc.server.port != 8080 ||
+				svc.server.run_mode != mode::safe || svc.server.tags.size() != 2 || svc.server.backlog != 128) {
+					std::cout << "server wasn't bound properly\n";
+					return false;
+				}
+				if (svc.limits.at("cpu") != 1.5 || svc.limits.at("mem") != 512 || svc.ports != std::vector <int>{1, 2, 3} || svc.verbose ||
+				svc.flags != std::vector <bool>{true, false, true}) {
+					std::cout << "limits/ports weren't bound properly\n";
+					return false;
+				}
+				henifig::config_t broken;
+				broken << R"(/name\ | 1
+/server{
+  $"port" | 70000,
+  $"mode" | "slow"
+}\
+/ports[1, "2"]\
+)";
+				service_cfg out;
+				const henifig::bind_errors errors = henifig::bind(broken, out);
+				if (errors.size() != 7) {
+					for (const henifig::bind_error& error : errors) {
+						std::cout << error.path << " - " << error.details << '\n';
+					}
+					return false;
+				}
+				return true;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				std::string text;
+				for (size_t i = 0; i < 20000; i++) {
+					text += "/node " + std::to_string(i) + "{\n"
+					"  $\"host\" | \"localhost\",\n"
+					"  $\"port\" | 8080,\n"
+					"  $\"timeout\" | 1.5,\n"
+					"  $\"mode\" | \"fast\",\n"
+					"  $\"region\" | \"eu-west\"\n"
+					"}\\\n";
+				}
+				const std::shared_ptr <henifig::string_pool> pool = std::make_shared <henifig::string_pool>();
+				henifig::config_t first, second;
+				first.set_string_pool(pool);
+				second.set_string_pool(pool);
+				const bool log_process = henifig::process_logger::is_enabled();
+				henifig::process_logger::set_enabled(false);
+				first << text;
+				second << text;
+				henifig::process_logger::set_enabled(log_process);
+				// 5 keys and 3 distinct string values in 200k map entries.
+				if (pool->size() != 8) {
+					std::cout << "pool size: " << pool->size() << '\n';
+					return false;
+				}
+				const henifig::value_map& node = first["node 19999"];
+				if (node.at("region") != "eu-west" || node.begin()->first != second["node 0"].get <henifig::value_map>().begin()->first) {
+					return false;
+				}
+				henifig::string_pool other;
+				const henifig::istring own = pool->intern("eu-west"), foreign = other.intern("eu-west");
+				if (own.data() != node.at("region").get <henifig::istring>().data() || own != foreign || foreign == other.intern("fast")) {
+					return false;
+				}
+				std::cout << "interned " << pool->requested_bytes() << " bytes of strings into " << pool->bytes();
+				return true;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				std::string text = "/big{\n";
+				for (size_t i = 100; i > 0; i--) {
+					text += "  $\"k" + std::to_string(i) + "\" | " + std::to_string(i) + (i > 1 ? ",\n" : "\n");
+				}
+				text += "}\\\n";
+				henifig::config_t big;
+				big << text;
+				const henifig::value_map& map = big["big"];
+				size_t expected = 100;
+				for (const auto& [key, value] : map) {
+					if (key != "k" + std::to_string(expected) || value != expected || map.at(key) != expected) {
+						std::cout << "unexpected entry " << key << '\n';
+						return false;
+					}
+					--expected;
+				}
+				const std::unordered_map <std::string, int> converted = big["big"];
+				const std::map <std::string, int> sorted = big["big"];
+				if (converted.size() != 100 || sorted.begin()->first != "k1" || map.contains("k0") || map.find("k50") == map.end()) {
+					return false;
+				}
+				try {
+					big << text.substr(0, text.size() - 3) + ",\n  $\"k20\" | 1\n}\\\n";
+				}
+				catch (const henifig::parse_exception& e) {
+					return std::string(e.what()).find("redeclared map value key") != std::string::npos;
+				}
+				return false;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[&cfg]() -> bool {
+			try {
+				const henifig::value_array& arr = cfg["arr"];
+				return sizeof(henifig::value_t) == 16 &&
+				cfg["hello"].is <std::string>() && cfg["hello"].get <std::string>() == "Hello, World!" &&
+				cfg["arr"].is <henifig::value_array>() && cfg["arr"].index() == henifig::array &&
+				arr[0].is <henifig::value_map>() && arr[1].is <double>() && arr[1].get <double>() == -.1;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				henifig::config_t strings;
+				strings << R"(/esc\ | "a\"b\\c\nd"
+/cat\ | "x" "y"
+/plain\ | "just text"
+/arr["p", "q\n", ""]\
+)";
+				const std::string_view plain = strings["plain"];
+				const henifig::value_array& arr = strings["arr"];
+				return plain == "just text" && strings["plain"].is <std::string_view>() &&
+				strings["esc"].get <std::string_view>() == "a\"b\\c\nd" && strings["cat"].get <std::string_view>() == "xy" &&
+				arr[0].get <std::string_view>() == "p" && arr[1] == "q\n" && arr[2].get <std::string_view>().empty();
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				const auto source = std::make_shared <const std::string>(R"(/plain\ | "in place"
+/esc\ | "a\nb"
+/m{ $"k" | "v" }\
+)");
+				henifig::config_t in_place;
+				in_place.read_in_place(*source, source);
+				const auto inside = [&source](const std::string_view x) {
+					return x.data() >= source->data() && x.data() + x.size() <= source->data() + source->size();
+				};
+				const henifig::value_map& m = in_place["m"];
+				if (!inside(in_place["plain"].get <std::string_view>()) || !inside(m.at("k").get <std::string_view>()) ||
+				inside(in_place["esc"].get <std::string_view>()) || in_place["esc"] != "a\nb") {
+					return false;
+				}
+				// Asking for a std::string copies it out of the buffer.
+				const std::string& plain = in_place["plain"];
+				if (plain != "in place" || inside(plain) || std::string_view(in_place["plain"].get <std::string>().c_str()) != "in place") {
+					return false;
+				}
+				const henifig::config_t copy = in_place;
+				in_place.clear();
+				return copy["plain"] == "in place" && !inside(copy["plain"].get <std::string_view>()) && source.use_count() == 1;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				henifig::config_t tables;
+				tables << R"(/weights[0.5, 1.5, -2.25]\
+/ports[80, 443, 8080]\
+/offsets[-1, -2]\
+/flags[true, false, true]\
+/mixed[1, -2]\
+/late[1, 2, 3, "x"]\
+/nested[[1, 2], [3]]\
+)";
+				const henifig::span <const double> weights = tables["weights"].get_span <double>();
+				if (weights.size() != 3 || weights[2] != -2.25 || !tables["ports"].is_packed <unsigned long long>() ||
+				tables["offsets"].get_span <long long>()[1] != -2 || !tables["flags"].get_span <bool>()[2] ||
+				tables["mixed"].is_packed <long long>() || !tables["nested"][0].is_packed <unsigned long long>()) {
+					std::cout << "arrays weren't packed properly\n";
+					return false;
+				}
+				const henifig::value_array& ports = tables["ports"];
+				const std::vector <double> weights_copy = tables["weights"];
+				const henifig::value_array& late = tables["late"];
+				if (ports.size() != 3 || ports[2] != 8080 || weights_copy[0] != 0.5 || tables["flags"][1] != false ||
+				tables["late"].is_packed <unsigned long long>() || late.size() != 4 || late[2] != 3 || late[3] != "x") {
+					std::cout << "packed arrays weren't boxed properly\n";
+					return false;
+				}
+				return tables.to_json().find(R"("offsets" : [-1, -2])") != std::string::npos;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				std::string text = "/big[";
+				for (size_t i = 0; i < 100000; i++) {
+					text += std::to_string(i) + (i < 99999 ? ", " : "]\\\n");
+				}
+				text += "/rows[[1, 2], [3]]\\\n/names{\n  $\"a\" | [\"x\"],\n  $\"b\" | [\"y\", \"z\"]\n}\\\n";
+				henifig::config_t batch;
+				const bool log_process = henifig::process_logger::is_enabled();
+				henifig::process_logger::set_enabled(false);
+				batch << text;
+				henifig::process_logger::set_enabled(log_process);
+				std::vector <int> big(200000);
+				const int* storage = big.data();
+				batch["big"].extract(big);
+				if (big.size() != 100000 || big.data() != storage || big[99999] != 99999) {
+					std::cout << "big wasn't extracted in place\n";
+					return false;
+				}
+				std::vector <long long> copied;
+				batch["big"].copy_to <long long>(std::back_inserter(copied));
+				std::vector <std::vector <unsigned>> rows;
+				batch["rows"].extract(rows);
+				std::unordered_map <std::string, std::vector <std::string>> names;
+				batch["names"].extract(names);
+				if (copied.size() != 100000 || rows.size() != 2 || rows[0][1] != 2 || rows[1][0] != 3 || names.at("b")[1] != "z") {
+					std::cout << "containers weren't extracted properly\n";
+					return false;
+				}
+				try {
+					std::vector <double> wrong;
+					batch["big"].extract(wrong);
+				}
+				catch (const std::bad_variant_access&) {
+					return true;
+				}
+				return false;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				const bool log_process = henifig::process_logger::is_enabled();
+				henifig::process_logger::set_enabled(false);
+				henifig::config_t app("../includes/app.hfg");
+				henifig::config_t again("../includes/app.hfg");
+				henifig::process_logger::set_enabled(log_process);
+				const std::vector <std::string>& vars = app.get_vars();
+				if (vars.size() != 5 || vars.front() != "shared_name" || vars.back() != "own" || app["own"] != true) {
+					std::cout << "included variables weren't merged properly\n";
+					return false;
+				}
+				if (app["server"]["port"] != 8080ULL || app["base_level"] != 3ULL || app["shared_list"][2] != 3ULL) {
+					std::cout << "included values are wrong\n";
+					return false;
+				}
+				// The cached include is shared rather than parsed again.
+				if (&again["shared_list"].get <henifig::value_array>() != &app["shared_list"].get <henifig::value_array>()) {
+					std::cout << "the include cache wasn't used\n";
+					return false;
+				}
+				for (const auto& [file, code] : {
+					std::pair {"../includes/cycle_a.hfg", henifig::INCLUDE_CYCLE},
+					std::pair {"../includes/clash.hfg", henifig::REDECLARED_VAR},
+				}) {
+					try {
+						henifig::config_t broken(file);
+						std::cout << file << " was parsed\n";
+						return false;
+					}
+					catch (const henifig::parse_exception& e) {
+						if (std::string_view(e.what()).find(henifig::error_messages[code]) == std::string_view::npos) {
+							std::cout << e.what() << '\n';
+							return false;
+						}
+					}
+				}
+				henifig::config_t::clear_include_cache();
+				return true;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			const std::filesystem::path dir = std::filesystem::temp_directory_path() / "henifig_include_test";
+			try {
+				std::filesystem::create_directories(dir);
+				const std::string outer = (dir / "outer.hfg").string();
+				std::ofstream(outer) << "@include \"middle.hfg\"\n";
+				std::ofstream(dir / "middle.hfg") << "@include \"inner.hfg\"\n";
+				std::ofstream(dir / "inner.hfg") << "/level\\ | 1\n";
+				const bool log_process = henifig::process_logger::is_enabled();
+				henifig::process_logger::set_enabled(false);
+				const henifig::config_t before(outer);
+				// Only a file included through another one changes, the cached outer files mustn't be reused.
+				std::ofstream(dir / "inner.hfg") << "/level\\ | 2\n";
+				const henifig::config_t after(outer);
+				henifig::process_logger::set_enabled(log_process);
+				henifig::config_t::clear_include_cache();
+				std::filesystem::remove_all(dir);
+				return before["level"] == 1ULL && after["level"] == 2ULL;
+			}
+			catch (const std::exception& e) {
+				std::filesystem::remove_all(dir);
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				const bool log_process = henifig::process_logger::is_enabled();
+				henifig::process_logger::set_enabled(false);
+				henifig::config_t flat;
+				{
+					henifig::config_t base, region, host;
+					base << "/name\\ | \"base\"\n/limits{ $\"cpu\" | 1, $\"mem\" | 512, $\"disk\" | { $\"size\" | 10, $\"kind\" | \"hdd\" } }\\\n/ports[80, 443]\\\n";
+					region << "/limits{ $\"mem\" | 1024, $\"disk\" | { $\"kind\" | \"ssd\" } }\\\n/zone\\ | \"eu\"\n";
+					host << "/limits{ $\"cpu\" | 4 }\\\n/ports[8080]\\\n";
+					henifig::process_logger::set_enabled(log_process);
+					const henifig::overlay_t layers{base, region, host};
+					const henifig::overlay_node limits = layers["limits"];
+					if (limits["cpu"].get <unsigned long long>() != 4 || limits["mem"].get <unsigned long long>() != 1024 ||
+						limits["disk"]["kind"].get <std::string>() != "ssd" || limits["disk"]["size"].get <unsigned long long>() != 10) {
+						std::cout << "nested keys weren't resolved by precedence\n";
+						return false;
+					}
+					if (layers["ports"].get <henifig::value_array>().size() != 1 || layers["zone"].get <std::string>() != "eu" || layers["missing"].exists()) {
+						std::cout << "top-level variables weren't resolved by precedence\n";
+						return false;
+					}
+					// Values nobody overrides are the ones of their layer, not copies.
+					if (&layers["name"].value() != &base["name"]) {
+						std::cout << "a value was copied\n";
+						return false;
+					}
+					// Looking a name up doesn't copy it, however long it is.
+					const size_t before = allocations;
+					if (layers.contains("a_name_too_long_for_small_strings") || layers["a_name_too_long_for_small_strings"].exists() || allocations != before) {
+						std::cout << "a lookup allocated\n";
+						return false;
+					}
+					flat = layers.flatten();
+				}
+				const std::vector <std::string> vars{"name", "limits", "ports", "zone"};
+				if (flat.get_vars() != vars || flat["limits"]["disk"]["kind"].get <std::string>() != "ssd" || flat["limits"]["cpu"] != 4ULL ||
+					flat["ports"][0] != 8080ULL || flat.to_json() != R"({
+    "name" : "base",
+    "limits" : {
+        "cpu" : 4,
+        "mem" : 1024,
+        "disk" : {
+            "size" : 10,
+            "kind" : "ssd"
+        }
+    },
+    "ports" : [8080],
+    "zone" : "eu"
+})") {
+					std::cout << flat.to_json() << "\nisn't the flattened config\n";
+					return false;
+				}
+				return true;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			try {
+				const bool log_process = henifig::process_logger::is_enabled();
+				henifig::process_logger::set_enabled(false);
+				henifig::config_t base;
+				base << "/name\\ | \"base\"\n/server{ $\"host\" | \"localhost\", $\"ports\" | [80, 443] }\\\n/debug\\ | false\n";
+				henifig::process_logger::set_enabled(log_process);
+				const henifig::snapshot_t first(base);
+				const henifig::snapshot_t second = first
+					.set({"server", "ports", 0}, 8080)
+					.push_back({"server", "ports"}, 8443)
+					.insert({"server"}, "timeout", 30)
+					.set({"name"}, "edited")
+					.erase({"debug"});
+				if (first["server"]["ports"][0].get <unsigned long long>() != 80 || first["server"]["ports"].size() != 2 ||
+					first["name"].get <std::string>() != "base" || !first.contains("debug") || first["server"].contains("timeout")) {
+					std::cout << "the first snapshot was changed\n";
+					return false;
+				}
+				const std::vector <std::string_view> vars{"name", "server"};
+				if (second.get_vars() != vars || second["server"]["ports"][0].get <unsigned long long>() != 8080 ||
+					second["server"]["ports"][2].get <unsigned long long>() != 8443 || second.find({"server", "timeout"})->get <unsigned long long>() != 30) {
+					std::cout << "the second snapshot is wrong\n";
+					return false;
+				}
+				if (second.to_config().to_json() != R"({
+    "name" : "edited",
+    "server" : {
+        "host" : "localhost",
+        "ports" : [8080, 443, 8443],
+        "timeout" : 30
+    }
+})") {
+					std::cout << second.to_config().to_json() << "\nisn't the edited config\n";
+					return false;
+				}
+				// An edit only copies the nodes on its path, everything else is shared with the previous snapshot.
+				henifig::snapshot_t big;
+				for (int i = 0; i < 1000; i++) {
+					big = big.set({"var" + std::to_string(i)}, i);
+				}
+				const henifig::snapshot_t edited = big.set({"var500"}, -1);
+				int shared{};
+				for (int i = 0; i < 1000; i++) {
+					const std::string var = "var" + std::to_string(i);
+					shared += &big[var] == &edited[var];
+				}
+				if (shared < 950 || edited["var500"].get <long long>() != -1 || big["var500"].get <unsigned long long>() != 500) {
+					std::cout << shared << " values were shared\n";
+					return false;
+				}
+				try {
+					(void)first.push_back({"name"}, 1);
+				}
+				catch (const henifig::retrieval_exception&) {
+					return true;
+				}
+				return false;
+			}
+			catch (const std::exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+		},
+		[]() -> bool {
+			event_log events;
+			events.input = R"(/decl\
+/str\ | "plain" # a comment
+/esc\ | "a\"b" "c"
+/arr[1, [true], {
+  $"k" | "v", $"d"
+}]\
+)";
+			henifig::sax_parser parser(events);
+			if (const henifig::parse_report report = parser.parse(events.input); report.is_error()) {
+				std::cout << henifig::parse_exception(report).what() << '\n';
+				return false;
+			}
+			if (events.log != R"(var(decl) decl var(str) "plain" var(esc) "a"bc" var(arr) [ 1 [ true ] { key(k) "v" key(d) decl } ] )") {
+				std::cout << events.log << '\n';
+				return false;
+			}
+			// Only the strings with no escapes or continuations are viewed straight from the input.
+			if (events.views != 2) {
+				std::cout << events.views << " strings were viewed\n";
+				return false;
+			}
+			const henifig::parse_report report = parser.parse("/fine\\\n/forbidden\\ | 1\n");
+			return report.get_error_code() == henifig::REDECLARED_VAR && report.get_error_line() == 2 && report.get_parse_error_details() == "forbidden";
+		},
+		[]() -> bool {
+			using token = henifig::reader::token;
+			const std::string input = R"(/skipped{
+  $"tricky" | "}]", $"nested" | [[1, [# ] #] 2], '['] # }
+}\
+/port\ | 8080
+/hosts["a", "b\"c"]\
+/after\ | true
+)";
+			henifig::reader reader(input);
+			if (!reader.next_var() || reader.name() != "skipped" || !reader.next() || reader.type() != token::map_begin) {
+				return false;
+			}
+			reader.skip();
+			if (!reader.next() || reader.type() != token::var || reader.name() != "port" || !reader.next() || reader.get <unsigned long long>() != 8080) {
+				return false;
+			}
+			std::vector <std::string> hosts;
+			bool viewed = false;
+			if (!reader.next_var() || !reader.next() || reader.type() != token::array_begin) {
+				return false;
+			}
+			while (reader.next() && reader.type() == token::scalar) {
+				if (reader.depth() != 1) {
+					return false;
+				}
+				const std::string_view host = reader.get <std::string_view>();
+				// Strings without escapes are looked at right in the buffer.
+				viewed |= host.data() >= input.data() && host.data() < input.data() + input.size();
+				hosts.emplace_back(host);
+			}
+			if (hosts != std::vector <std::string>{"a", "b\"c"} || !viewed) {
+				return false;
+			}
+			if (!reader.next_var() || reader.name() != "after" || !reader.next() || !reader.get <bool>() || reader.get_line() != 6) {
+				return false;
+			}
+			if (reader.next() || reader.get_report().is_error()) {
+				return false;
+			}
+			henifig::reader hanging("/a[1, {$\"k\" | 2}\n/b\\ | 1\n");
+			hanging.next();
+			hanging.next();
+			hanging.skip();
+			return !hanging.next() && hanging.get_report().get_error_code() == henifig::HANGING_ARR;
+		},
+		[]() -> bool {
+			const std::string input = R"(/str\ | "esc\"aped" [# a comment
+spanning # lines #] "and continued"
+/chr\ | '\''
+/num\ | -.25 # a line comment
+/map{
+  $"k\"ey" | [1, 2, 3], [##] $"decl"
+}\
+)";
+			henifig::config_t whole;
+			whole << input;
+			const std::string expected = whole.to_json();
+			// Cut the input at every possible place, whatever's being read there.
+			for (size_t cut = 0; cut <= input.size(); cut++) {
+				henifig::config_t cfg;
+				cfg.feed(std::string_view(input).substr(0, cut));
+				cfg.feed(std::string_view(input).substr(cut));
+				cfg.finish();
+				if (cfg.to_json() != expected) {
+					std::cout << "Cut at " << cut << ":\n" << cfg.to_json() << '\n';
+					return false;
+				}
+			}
+			henifig::config_t bytes;
+			for (const char c : input) {
+				bytes.feed({&c, 1});
+			}
+			bytes.finish();
+			if (bytes.to_json() != expected) {
+				return false;
+			}
+			// Feeding a new config into the same one replaces the previous contents.
+			try {
+				bytes.feed("/str\\ | \"again\"\n/other\\ | ");
+				bytes.feed("1\n");
+				bytes.finish();
+			}
+			catch (const henifig::parse_exception& e) {
+				std::cout << e.what() << '\n';
+				return false;
+			}
+			if (bytes.get_vars().size() != 2 || bytes["str"] != "again" || bytes["other"] != 1ULL) {
+				std::cout << "the second fed config got mixed up with the first one\n";
+				return false;
+			}
+			henifig::config_t hanging;
+			hanging.feed("/str\\ | \"never");
+			try {
+				hanging.finish();
+			}
+			catch (const henifig::parse_exception& e) {
+				return std::string_view(e.what()).find(henifig::error_messages[henifig::HANGING_QUOTE]) != std::string_view::npos;
+			}
+			return false;
+		},
+		[]() -> bool {
+			const std::string tenants[] = {
+				"/tenant\\ | \"north\"\n/limits{ $\"requests per second\" | 1000, $\"burst\" | 50 }\\\n/zones[\"a\", \"b\", \"c\"]\\\n/ratios[0.5, 0.25]\\\n",
+				"/tenant\\ | \"south-east-and-beyond\"\n/limits{ $\"requests per second\" | 10, $\"burst\" | 5, $\"queue\" | 64 }\\\n/zones[\"d\"]\\\n/ratios[1.0]\\\n",
+			};
+			henifig::parser parser;
+			henifig::config_t cfg;
+			henifig::process_logger::set_enabled(false);
+			// The first rounds grow the buffers big enough for both tenants.
+			for (int i = 0; i < 4; i++) {
+				parser.parse(tenants[i % 2], cfg);
+			}
+			const size_t before = allocations;
+			for (int i = 0; i < 100; i++) {
+				parser.parse(tenants[i % 2], cfg);
+			}
+			const size_t steady = allocations - before;
+			henifig::process_logger::set_enabled(true);
+			if (steady != 0) {
+				std::cout << steady << " allocations in the steady state\n";
+				return false;
+			}
+			if (cfg["tenant"].get <std::string>() != "south-east-and-beyond" || cfg["limits"]["queue"].get <unsigned long long>() != 64 ||
+				cfg["zones"].get <henifig::value_array>().size() != 1 || cfg["ratios"][0].get <double>() != 1.0) {
+				return false;
+			}
+			// Pooled configs go back to the parser once they're released.
+			const henifig::config_t* first = nullptr;
+			{
+				const henifig::parser::config_ptr pooled = parser.parse(tenants[0]);
+				first = pooled.get();
+			}
+			const henifig::parser::config_ptr again = parser.parse(tenants[0]);
+			if (again.get() != first || (*again)["zones"][2].get <std::string>() != "c") {
+				return false;
+			}
+			// A bounded parser moves on to a new pool, the configs parsed into the old one keep it alive.
+			henifig::parser bounded;
+			bounded.set_pool_limit(256);
+			const henifig::parser::config_ptr kept = bounded.parse(tenants[1]);
+			const std::shared_ptr <henifig::string_pool> old_pool = bounded.get_string_pool();
+			henifig::process_logger::set_enabled(false);
+			for (int i = 0; i < 64; i++) {
+				const henifig::parser::config_ptr unique = bounded.parse("/name\\ | \"tenant " + std::to_string(i) + "\"\n");
+			}
+			henifig::process_logger::set_enabled(true);
+			if (bounded.get_string_pool() == old_pool || bounded.get_string_pool()->bytes() > 256 + 16 ||
+			(*kept)["tenant"].get <std::string>() != "south-east-and-beyond") {
+				std::cout << "the parser's string pool wasn't bounded\n";
+				return false;
+			}
+			try {
+				parser.parse("/broken\\ | ", cfg);
+			}
+			catch (const henifig::parse_exception&) {
+				parser.parse(tenants[0], cfg);
+				return cfg["limits"]["burst"].get <unsigned long long>() == 50;
+			}
+			return false;
+		},
+		[]() -> bool {
+			std::vector <std::string> documents;
+			for (size_t i = 0; i < 64; i++) {
+				// Every eighth document is much bigger than the rest, for the workers to even out.
+				std::string document = "/index\\ | " + std::to_string(i) + "\n/items[";
+				for (size_t j = 0; j < (i % 8 ? 4 : 4000); j++) {
+					document += std::to_string(j) + ", ";
+				}
+				documents.push_back(document + "0]\\\n");
+			}
+			documents[40] = "/broken[1, 2\n";
+			const std::vector <std::string_view> buffers(documents.begin(), documents.end());
+			henifig::process_logger::set_enabled(false);
+			henifig::batch_options parallel, stopping;
+			parallel.threads = 4;
+			stopping.threads = 1;
+			stopping.stop_on_error = true;
+			const std::vector <henifig::batch_item> loaded = henifig::load_buffers(buffers, parallel);
+			const std::vector <henifig::batch_item> stopped = henifig::load_buffers(buffers, stopping);
+			const std::vector <henifig::batch_item> files = henifig::load_files({"../includes/app.hfg", "../includes/missing.hfg"});
+			henifig::process_logger::set_enabled(true);
+			for (size_t i = 0; i < loaded.size(); i++) {
+				if (i == 40) {
+					if (loaded[i].cfg || loaded[i].report.get_error_code() != henifig::HANGING_ARR) {
+						return false;
+					}
+				}
+				else if (!loaded[i].cfg || (*loaded[i].cfg)["index"].get <unsigned long long>() != i) {
+					return false;
+				}
+			}
+			// A single thread takes the documents in order, so everything after the broken one is left.
+			if (!stopped[39].cfg || stopped[40].report.get_error_code() != henifig::HANGING_ARR || stopped[41].report.get_error_code() != henifig::LOAD_CANCELLED) {
+				return false;
+			}
+			return files.size() == 2 && files[0].cfg && !files[0].report.is_error() &&
+				files[1].report.get_error_code() == henifig::FILE_OPEN_FAILED;
+		},
+		[]() -> bool {
+			henifig::config_t cfg;
+			const henifig::parse_report broken = cfg.try_parse("/port\\ | 80\n/hosts[\"a\"\n");
+			if (broken.get_error_code() != henifig::HANGING_ARR || cfg.find("port")) {
+				return false;
+			}
+			// Success doesn't allocate anything for the report.
+			const size_t before = allocations;
+			const henifig::parse_report fine = henifig::parse_report();
+			if (allocations != before || fine.is_error() || !fine.get_error_filename().empty()) {
+				return false;
+			}
+			if (const henifig::parse_report report = cfg.try_parse("/port\\ | 80\n/name\\ | \"svc\"\n/limits{ $\"cpu\" | 2.5 }\\\n/ids[4, 5]\\\n"); report.is_error()) {
+				std::cout << henifig::parse_exception(report).what() << '\n';
+				return false;
+			}
+			const std::string* name = cfg.get_if <std::string>("name");
+			if (!name || *name != "svc" || cfg.get_if <double>("port") || cfg.get_if <std::string>("missing")) {
+				return false;
+			}
+			if (cfg.value_or <int>("port", 0) != 80 || cfg.value_or <int>("name", -1) != -1 || cfg.value_or <std::string>("missing", "none") != "none") {
+				return false;
+			}
+			const henifig::value_t* limits = cfg.find("limits");
+			if (!limits || !limits->find("cpu") || limits->find("ram") || limits->find(0) || limits->find("cpu")->value_or(0.0) != 2.5) {
+				return false;
+			}
+			const henifig::value_t& ids = cfg["ids"];
+			return ids.find(1) && ids.find(1)->value_or <long>(0) == 5 && !ids.find(2) && !ids.find("key") && ids.value_or <bool>(true);
+		},
+		[]() -> bool {
+			henifig::config_t cfg;
+			henifig::process_logger::set_enabled(false);
+			const std::vector <henifig::parse_report> errors = cfg.validate(R"(/fine\ | 1
+/unclosed[1, 2
+/trailing[1, 2,]\
+@include "../includes/cycle_a.hfg"
+/keys{ $"k" | 1, $"k" | 2 }\
+/fine\ | 3
+@include "../includes/missing.hfg"
+/also fine\ | "x"
+)");
+			const std::vector <henifig::parse_report> none = cfg.validate("/a\\ | 1\n/b\\ | 2\n");
+			henifig::process_logger::set_enabled(true);
+			// The declaration after the unclosed array is where it's found to be broken, and where parsing picks up again.
+			const std::vector <std::pair <henifig::error_codes, size_t>> expected = {
+				{henifig::UNEXPECTED_EXPRESSION, 3},
+				{henifig::HANGING_COMMA, 3},
+				{henifig::REDECLARED_KEY, 5},
+				{henifig::REDECLARED_VAR, 6},
+				// Reported where the cycle closes, in cycle_b.hfg.
+				{henifig::INCLUDE_CYCLE, 1},
+				{henifig::FILE_OPEN_FAILED, 7},
+			};
+			if (errors.size() != expected.size()) {
+				for (const henifig::parse_report& x : errors) {
+					std::cout << henifig::parse_exception(x).what() << '\n';
+				}
+				return false;
+			}
+			for (size_t i = 0; i < errors.size(); i++) {
+				if (errors[i].get_error_code() != expected[i].first || errors[i].get_error_line() != expected[i].second) {
+					std::cout << henifig::parse_exception(errors[i]).what() << '\n';
+					return false;
+				}
+			}
+			return none.empty() && cfg.value_or <int>("b", 0) == 2;
+		},
+		[]() -> bool {
+			henifig::config_t cfg;
+			cfg.set_track_locations(true);
+			cfg << R"(/name\ | "svc"
+/server{
+  $"host" | "localhost",
+  $"ports" | [80, 443]
+}\
+/flags[true, false]\
+)";
+			const henifig::value_t& server = cfg["server"];
+			const henifig::value_t& ports = server["ports"];
+			const auto at = [](const henifig::source_location& x, const size_t& line, const size_t& index) {
+				if (x.line != line || x.index != index) {
+					std::cout << "got " << x.line << ':' << x.index << ", expected " << line << ':' << index << '\n';
+					return false;
+				}
+				return true;
+			};
+			// Far into a big container, the position is found from the closest checkpoint.
+			henifig::config_t big;
+			big.set_track_locations(true);
+			std::string text = "/big[\n";
+			for (size_t i = 0; i < 1000; i++) {
+				text += std::string(i % 3 + 1, ' ') + std::to_string(i) + (i < 999 ? ",\n" : "\n");
+			}
+			henifig::process_logger::set_enabled(false);
+			big << text + "]\\\n";
+			henifig::process_logger::set_enabled(true);
+			for (const size_t i : {0, 63, 64, 65, 128, 500, 999}) {
+				if (!at(big.locate(big["big"], i), i + 2, i % 3 + 2)) {
+					return false;
+				}
+			}
+			henifig::config_t untracked;
+			untracked << "/a\\ | 1\n";
+			return !big.locate(big["big"], 1000).is_known() && at(cfg.locate_name("name"), 1, 1) && at(cfg.locate("name"), 1, 10) &&
+			at(cfg.locate_key(server, "ports"), 4, 3) && at(cfg.locate(server, "ports"), 4, 14) &&
+			at(cfg.locate(ports, 1), 4, 19) && at(cfg.locate(cfg["flags"], 1), 6, 14) &&
+			!cfg.locate(ports, 2).is_known() && !untracked.locate("a").is_known();
+		},
+		[]() -> bool {
+			// Low enough for an unoptimised build on a busy machine, while anything quadratic falls far below it.
+			constexpr double min_bytes_per_second = 256 * 1024;
+			constexpr size_t small_size = 16 * 1024, big_size = 8 * small_size;
+			henifig::process_logger::set_enabled(false);
+			bool res = true;
+			for (const adversarial_input& x : adversarial_corpus) {
+				const std::string small = x.make(small_size), big = x.make(big_size);
+				const double small_time = best_parse_time(small), big_time = best_parse_time(big);
+				const double bytes_per_second = big.size() / big_time;
+				std::cout << x.name << ": " << static_cast <size_t>(bytes_per_second / 1024) << " KiB/s\n";
+				// 8 times the input may take a few times longer than 8 times as long, not 64 times.
+				if (small_time < 0 || big_time < 0 || bytes_per_second < min_bytes_per_second || big_time > small_time * 8 * 4 + 0.005) {
+					std::cout << x.name << " is too slow: " << small_time << "s for " << small.size() << " bytes, " <<
+					big_time << "s for " << big.size() << " bytes\n";
+					res = false;
+				}
+			}
+			// Nor does a hostile token make its error any bigger than a normal one.
+			henifig::config_t broken;
+			const henifig::parse_report report = broken.try_parse("/a\\ | " + std::string(big_size, '1') + ".9\n");
+			henifig::process_logger::set_enabled(true);
+			return res && report.get_error_code() == henifig::WRONG_EXPRESSION && report.get_parse_error_details().size() < 300;
+		},
+		[]() -> bool {
+			henifig::process_logger::set_enabled(false);
+			const auto limited = [](const std::string& content, const auto& set) {
+				henifig::parse_options options;
+				set(options);
+				henifig::config_t cfg;
+				cfg.set_options(options);
+				return cfg.try_parse(content).get_error_code();
+			};
+			const std::string fine = "/a\\ | \"abc\"\n/b[1, [2, 3]]\\\n/c{ $\"k\" | 1 }\\\n";
+			const std::vector <std::pair <henifig::error_codes, henifig::error_codes>> results = {
+				{limited(fine, [](auto& x) { x.max_input_bytes = 8; }), henifig::INPUT_TOO_LARGE},
+				{limited(fine, [](auto& x) { x.max_depth = 1; }), henifig::TOO_DEEP},
+				{limited(fine, [](auto& x) { x.max_nodes = 6; }), henifig::TOO_MANY_NODES},
+				{limited(fine, [](auto& x) { x.max_string_length = 2; }), henifig::LITERAL_TOO_LONG},
+				{limited(fine, [](auto& x) { x.max_container_size = 1; }), henifig::CONTAINER_TOO_BIG},
+				{limited(fine, [](auto& x) { x.max_vars = 2; }), henifig::TOO_MANY_VARS},
+				{limited(fine, [](auto& x) { x.deadline = std::chrono::steady_clock::now(); }), henifig::DEADLINE_EXCEEDED},
+				{limited(fine, [](auto& x) {
+					static const std::atomic <bool> cancelled{true};
+					x.cancel = &cancelled;
+				}), henifig::PARSE_CANCELLED},
+				{limited(fine, [](auto& x) {
+					x.max_input_bytes = 64;
+					x.max_depth = 2;
+					x.max_nodes = 8;
+					x.max_string_length = 3;
+					x.max_container_size = 2;
+					x.max_vars = 3;
+				}), henifig::OK},
+			};
+			for (size_t i = 0; i < results.size(); i++) {
+				if (results[i].first != results[i].second) {
+					std::cout << "case " << i << ": " << henifig::error_messages[results[i].first] << '\n';
+					return false;
+				}
+			}
+			// A literal arriving in pieces is given up on soon after it passes the limit, however long it gets.
+			henifig::parse_options options;
+			options.max_string_length = 64;
+			henifig::config_t cfg;
+			cfg.set_options(options);
+			const std::string piece(4096, 'x');
+			const size_t before = allocations;
+			bool stopped = false;
+			try {
+				cfg.feed("/a\\ | \"");
+				for (size_t i = 0; i < 256; i++) {
+					cfg.feed(piece);
+				}
+			}
+			catch (const henifig::parse_exception& e) {
+				stopped = e.get_report().get_error_code() == henifig::LITERAL_TOO_LONG;
+			}
+			const size_t allocated = allocations - before;
+			// Nor can recovering carry on past a limit.
+			henifig::config_t recovering;
+			recovering.set_options(options);
+			const std::vector <henifig::parse_report> errors = recovering.validate("/a\\ | \"" + std::string(100, 'x') + "\"\n/b\\ | 1\n");
+			// Limited configs don't follow @include unless told to, and then share the limits with the included files.
+			const auto included = [](const std::optional <bool>& allow, const size_t& max_vars) {
+				henifig::parse_options options;
+				options.allow_includes = allow;
+				options.max_vars = max_vars;
+				henifig::config_t cfg;
+				cfg.set_options(options);
+				try {
+					cfg.open("../includes/app.hfg");
+				}
+				catch (const henifig::parse_exception& e) {
+					return e.get_report().get_error_code();
+				}
+				return henifig::OK;
+			};
+			// app.hfg declares 1 variable, base.hfg and server.hfg 1 each, and common.hfg 2 every time it's included.
+			const bool includes = included(std::nullopt, 7) == henifig::INCLUDE_NOT_ALLOWED &&
+			included(true, 3) == henifig::TOO_MANY_VARS && included(true, 7) == henifig::OK;
+			henifig::process_logger::set_enabled(true);
+			return stopped && allocated < 32 && errors.size() == 1 && errors[0].get_error_code() == henifig::LITERAL_TOO_LONG && includes;
+		},
+		[]() -> bool {
+			henifig::process_logger::set_enabled(false);
+			const auto same_config = [](const auto& built_in, const std::string_view text) {
+				henifig::config_t cfg;
+				if (cfg.try_parse(text).is_error() || cfg.get_vars().size() != built_in.size()) {
+					return false;
+				}
+				for (size_t i = 0; i < built_in.size(); i++) {
+					const henifig::static_value x = built_in.get_value(i);
+					if (x.key() != cfg.get_vars()[i] || !same_value(x, cfg.get_value(i))) {
+						std::cout << x.key() << " differs\n";
+						return false;
+					}
+				}
+				return true;
+			};
+			bool fine = same_config(embedded, embedded_text) && same_config(grammar, grammar_text);
+			// Texts which can't compile are read by the compile-time parser here, to fail the way the runtime one does.
+			const std::string texts[] = {
+				"/a#b\\ | 1\n", "/a[# c\n1]\\\n", "/a\\ | -#]\n", "/a\\ | 1.[# open\n", "/a\\ | t[# c #]rue\n",
+				"/m{$[# c\n#]\"k\"}\\\n", "/a\\ | \"x\"\n  \"y\n", "/a\\ | '\n", "/a\\ | \"\\\n", "/m{$\"k\" | \n",
+				"/a\\ | 18446744073709551616#]\n", "/a\\ | 18446744073709551616\n", "/a[1, 2,]\\\n", "/a[#] 1]\\\n",
+				"/a\\ | 1" + std::string(309, '0') + ".0\n", "/a\\ | 0." + std::string(400, '0') + "1\n",
+			};
+			for (const std::string& text : texts) {
+				henifig::config_t cfg;
+				const henifig::parse_report expected = cfg.try_parse(text);
+				henifig::error_codes code = henifig::OK;
+				size_t line = 0;
+				try {
+					static_cast <void>(henifig::detail::static_sizes_of(text));
+				}
+				catch (const henifig::parse_exception& e) {
+					code = e.get_report().get_error_code();
+					line = e.get_report().get_error_line();
+				}
+				if (code != expected.get_error_code() || line != expected.get_error_line()) {
+					std::cout << text << "failed with " << code << " on line " << line << " while compiling\n";
+					fine = false;
+				}
+			}
+			henifig::process_logger::set_enabled(true);
+			return fine;
+		},
+		[]() -> bool {
+			using henifig::schema;
+			const henifig::compiled_schema tenant = schema::map()
+				.required("name", schema::string().length(1, 32))
+				.required("port", schema::integer().range(1, 65535))
+				.optional("mode", schema::string().one_of({"fast", "safe"}))
+				.optional("ratio", schema::number().range(0, 1))
+				.required("tags", schema::array(schema::string()).length(1, 4))
+				.optional("limits", schema::array(schema::integer().range(0, 100)))
+				.required("server", schema::map().closed()
+					.required("host", schema::string())
+					.optional("tls", schema::boolean()))
+				.compile();
+			henifig::config_t good, bad;
+			henifig::process_logger::set_enabled(false);
+			good << "/name\\ | \"acme\"\n/port\\ | 80\n/tags[\"a\"]\\\n/limits[1, 2, 3]\\\n/server{ $\"host\" | \"h\", $\"tls\" | true }\\\n/other\\ | 1\n";
+			bad << "/name\\ | \"\"\n/port\\ | 70000\n/mode\\ | \"slow\"\n/ratio\\ | 2\n/tags[1, \"a\", \"b\", \"c\", \"d\"]\\\n"
+			"/limits[1, 200, 3]\\\n/server{ $\"tls\" | 1, $\"extra\" | 2 }\\\n";
+			henifig::process_logger::set_enabled(true);
+			// Every violation is reported, in the order of the config.
+			const std::vector <std::pair <std::string_view, std::string_view>> expected = {
+				{"name", "0 characters, expected between 1 and 32"},
+				{"port", "70000 is out of range, expected between 1 and 65535"},
+				{"mode", "`slow` isn't one of the allowed values"},
+				{"ratio", "2 is out of range, expected between 0 and 1"},
+				{"tags", "5 items, expected between 1 and 4"},
+				{"tags[0]", "expected string, got unsigned integer"},
+				{"limits[1]", "200 is out of range, expected between 0 and 100"},
+				{"server.tls", "expected boolean, got unsigned integer"},
+				{"server.extra", "unknown key"},
+				{"server.host", "missing key"},
+			};
+			const henifig::schema_violations violations = tenant.validate(bad);
+			if (violations.size() != expected.size()) {
+				return false;
+			}
+			for (size_t i = 0; i < expected.size(); i++) {
+				if (violations[i].path != expected[i].first || violations[i].details != expected[i].second) {
+					std::cout << violations[i].path << " - " << violations[i].details << '\n';
+					return false;
+				}
+			}
+			// Maps with many keys look them up through an index.
+			schema wide = schema::map();
+			for (int i = 0; i < 20; i++) {
+				wide.optional("k" + std::to_string(i), schema::integer());
+			}
+			wide.required("k20", schema::integer());
+			const henifig::compiled_schema wide_compiled = wide.compile();
+			// Maps with more than 64 keys are checked without allocating once a reused scratch has grown.
+			schema huge = schema::map();
+			std::string huge_text = "/huge{ ";
+			for (int i = 0; i < 100; i++) {
+				huge.required("k" + std::to_string(i), schema::map().required("k", schema::integer()));
+				huge_text += "$\"k" + std::to_string(i) + "\" | { $\"k\" | 1 }" + (i < 99 ? ", " : " }\\\n");
+			}
+			const henifig::compiled_schema huge_compiled = schema::map().required("huge", huge).compile();
+			henifig::config_t huge_cfg;
+			henifig::process_logger::set_enabled(false);
+			huge_cfg << huge_text;
+			henifig::process_logger::set_enabled(true);
+			henifig::schema_violations none;
+			henifig::validation_scratch scratch;
+			const bool huge_fine = huge_compiled.validate(huge_cfg, none, scratch);
+			const size_t before = allocations;
+			const bool huge_again = huge_compiled.validate(huge_cfg, none, scratch);
+			if (!huge_fine || !huge_again || allocations != before) {
+				std::cout << "validating a big map allocated\n";
+				return false;
+			}
+			return tenant.validate(good).empty() && wide_compiled.validate(good).size() == 1 &&
+			wide_compiled.validate(good)[0].path == "k20";
+		},
+		[]() -> bool {
+			const std::string text = "/name\\ | \"n\"\n/list[1, 2, 3]\\\n/mixed[\"a\", { $\"k\" | [true, 'c'] }]\\\n/m{ $\"x\" | { $\"y\" | 1.5 } }\\\n";
+			henifig::process_logger::set_enabled(false);
+			const auto same = [](const henifig::config_t& cfg) {
+				return cfg["name"].get <std::string>() == "n" && cfg["list"][2].get <unsigned long long>() == 3 &&
+				cfg["mixed"][1]["k"][1].get <char>() == 'c' && cfg["m"]["x"]["y"].get <double>() == 1.5;
+			};
+			std::optional <henifig::config_t> original;
+			original.emplace();
+			original->set_track_locations(true);
+			*original << text;
+			// A copy owns everything it holds, it outlives the original.
+			henifig::config_t copy(*original);
+			original.reset();
+			bool fine = same(copy) && copy.locate(copy["mixed"][1], "k").line == 3 && copy.locate(copy["m"]["x"], "y").line == 4;
+			// Moving keeps the values where they are.
+			const henifig::value_t* list = &copy["list"];
+			const size_t before = allocations;
+			henifig::config_t moved(std::move(copy));
+			henifig::config_t empty;
+			empty = std::move(moved);
+			moved = std::move(empty);
+			// Neither making a config nor moving one allocates.
+			fine = fine && allocations == before && same(moved) && &moved["list"] == list;
+			copy << "/other\\ | 1";
+			// Converting a config without strings, or a copy of one, doesn't grow the process-wide pool.
+			henifig::config_t numbers;
+			numbers << "/only_numbers_here\\ | 1";
+			const henifig::config_t numbers_copy(numbers);
+			const size_t global_size = henifig::string_pool::global()->size();
+			const henifig::value_map converted = numbers, converted_copy = numbers_copy;
+			fine = fine && converted.at("only_numbers_here").get <unsigned long long>() == 1 &&
+			converted_copy.count("only_numbers_here") && henifig::string_pool::global()->size() == global_size;
+			// Configs can be kept by value in a vector which reallocates.
+			std::vector <henifig::config_t> many;
+			for (int i = 0; i < 100; i++) {
+				many.push_back(moved);
+			}
+			many.emplace_back(std::move(moved));
+			for (const henifig::config_t& cfg : many) {
+				fine = fine && same(cfg);
+			}
+			henifig::config_t other;
+			other << "/other\\ | 2";
+			using std::swap;
+			swap(many[0], other);
+			many[1] = many[0];
+			many[2] = std::move(many[3]);
+			henifig::process_logger::set_enabled(true);
+			return fine && copy["other"].get <unsigned long long>() == 1 && same(other) &&
+			many[0]["other"].get <unsigned long long>() == 2 && many[1]["other"].get <unsigned long long>() == 2 &&
+			same(many[2]) && many[1].find("name") == nullptr;
+		},
+		[]() -> bool {
+			henifig::config_t cfg;
+			henifig::process_logger::set_enabled(false);
+			std::string text = "/name\\ | \"shared\"\n/list[1, 2, 3]\\\n/items[\"a\", { $\"k\" | [true, 'c', -4] }, 0.25]\\\n/big{";
+			for (int i = 0; i < 20; i++) {
+				text += (i ? ", $\"key" : " $\"key") + std::to_string(19 - i) + "\" | " + std::to_string(i);
+			}
+			cfg << text + " }\\\n/decl\\\n";
+			henifig::process_logger::set_enabled(true);
+			const auto same = [&cfg](const henifig::shared_config& shared) {
+				if (shared.size() != cfg.get_vars().size()) {
+					return false;
+				}
+				for (size_t i = 0; i < shared.size(); i++) {
+					if (shared.get_value(i).key() != cfg.get_vars()[i] || !same_value(shared.get_value(i), cfg.get_value(i))) {
+						return false;
+					}
+				}
+				return shared["big"]["key7"].get <unsigned long long>() == 12 && !shared["big"].contains("key20");
+			};
+			// Forked children read what the parent published, without parsing it.
+			const auto in_child = [](const std::function <bool()>& check) {
+				const pid_t child = fork();
+				if (!child) {
+					_exit(check() ? 0 : 1);
+				}
+				int status{};
+				return child > 0 && waitpid(child, &status, 0) == child && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+			};
+			std::vector <unsigned char> image = henifig::make_shared_image(cfg);
+			bool fine = same(henifig::shared_config::view(image.data(), image.size()));
+			image[sizeof(henifig::shared_header) + 8] = 0xFF;
+			try {
+				(void)henifig::shared_config::view(image.data(), image.size());
+				fine = false;
+			}
+			catch (const henifig::retrieval_exception&) {}
+
+			const int fd = henifig::shared_config::publish_memfd(cfg);
+			fine = fine && in_child([&]() {
+				return same(henifig::shared_config::attach(fd));
+			});
+			close(fd);
+
+			const std::string name = "/henifig-test-" + std::to_string(getpid());
+			const uint64_t first = henifig::shared_config::publish(cfg, name);
+			const henifig::shared_config attached = henifig::shared_config::attach(name);
+			fine = fine && same(attached) && attached.generation() == first && !attached.outdated() && in_child([&]() {
+				return same(henifig::shared_config::attach(name));
+			});
+			// A new generation replaces the old one at once, those reading the old one keep it until they let it go.
+			henifig::config_t next;
+			next << "/name\\ | \"next\"";
+			const uint64_t second = henifig::shared_config::publish(next, name);
+			const henifig::shared_config updated = henifig::shared_config::attach(name);
+			fine = fine && second == first + 1 && attached.outdated() && same(attached) && in_child([&]() {
+				const henifig::shared_config x = henifig::shared_config::attach(name);
+				return x.generation() == second && x["name"].get <std::string_view>() == "next" && x.size() == 1;
+			});
+			henifig::shared_config::unpublish(name);
+			return fine && updated["name"].get <std::string_view>() == "next";
+		},
+#ifdef HENIFIG_TEST_GENERATED
+		[]() -> bool {
+			generated::sample s;
+			const bool defaults = s.name == "sample" && s.port == 8080 && s.tags.size() == 2 && s.server.max_conn == 64 &&
+			s.server.tls.on && s.users.size() == 2 && s.users[0].id == 1 && !s.users[0].admin && s.users[1].admin;
+			const henifig::parse_report report = generated::load(
+				"/port\\ | 9\n"
+				"/unknown{ $\"x\" | [1, {$\"y\" | 2}] }\\\n"
+				"/server{ $\"tls\" | { $\"on\" | false }, $\"extra\" | 1 }\\\n"
+				"/users[{ $\"name\" | \"zed\", $\"admin\" }]\\\n"
+				"/ratio\\ | 2\n", s);
+			const bool loaded = !report.is_error() && s.port == 9 && s.name == "sample" && s.ratio == 2.0 &&
+			!s.server.tls.on && s.server.host == "localhost" && s.users.size() == 1 && s.users[0].name == "zed" && s.users[0].id == 0;
+			// Values which don't fit their fields stop the loading where they are.
+			const henifig::parse_report mismatch = generated::load("/tags[\"x\", 1]\\", s);
+			bool thrown = false;
+			try {
+				(void)generated::load_sample("/server\\ | true");
+			}
+			catch (const henifig::parse_exception& e) {
+				thrown = e.get_report().get_error_code() == henifig::TYPE_MISMATCH;
+			}
+			return defaults && loaded && mismatch.get_error_code() == henifig::TYPE_MISMATCH &&
+			mismatch.get_error_index() == 13 && thrown;
+		},
+#endif
 	};
 	if (argc != 2) {
 		int failed{};
@@ -0,0 +1,687 @@
+/**************************************************************************
+ * Copyright 2025 Ramskyi Roman
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+
+ * http://www.apache.org/licenses/LICENSE-2.0
+
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+***************************************************************************/
+
+
+/*
+ * henifig-gen reads a sample config and writes a header with a struct of the same shape and a loader
+ * which fills it straight from a sax_parser: every name is matched once against the fields it can be,
+ * and every value is written to its member without building a value_t.
+ * The values in the sample become the defaults of the struct.
+ *
+ * Usage: henifig-gen <sample.hfg> <output.hpp> [--namespace <name>] [--struct <name>]
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "henifig/henifig.hpp"
+
+namespace {
+	struct shape {
+		std::string key;
+		std::string field;
+		henifig::data_types type{};
+		// The name of the struct of a map, or of the innermost items of an array.
+		std::string type_name;
+		std::vector <shape> fields;
+		// The items of an array, one at most.
+		std::vector <shape> items;
+		int slot{};
+		// What the loader writes the value to, and what it adds the value to if it's an array item.
+		std::string expr;
+		std::string parent_expr;
+		bool element{};
+	};
+
+	[[noreturn]] void fail(const std::string& path, const std::string& what) {
+		throw std::runtime_error('`' + path + "`: " + what);
+	}
+
+	bool is_keyword(const std::string_view word) {
+		static const std::set <std::string_view> keywords = {
+			"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool", "break", "case", "catch",
+			"char", "char8_t", "char16_t", "char32_t", "class", "compl", "concept", "const", "consteval", "constexpr",
+			"constinit", "const_cast", "continue", "co_await", "co_return", "co_yield", "decltype", "default", "delete",
+			"do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern", "false", "float", "for",
+			"friend", "goto", "if", "inline", "int", "long", "mutable", "namespace", "new", "noexcept", "not", "not_eq",
+			"nullptr", "operator", "or", "or_eq", "private", "protected", "public", "register", "reinterpret_cast",
+			"requires", "return", "short", "signed", "sizeof", "static", "static_assert", "static_cast", "struct",
+			"switch", "template", "this", "thread_local", "throw", "true", "try", "typedef", "typeid", "typename",
+			"union", "unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor", "xor_eq",
+		};
+		return keywords.count(word);
+	}
+
+	/**
+	 * @brief A C++ identifier for a name: anything but letters, digits and '_' becomes '_'.
+	 */
+	std::string identifier(const std::string_view name) {
+		std::string res;
+		for (const char c : name) {
+			const bool fits = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+			res += fits ? c : '_';
+		}
+		if (res.empty() || (res[0] >= '0' && res[0] <= '9')) {
+			res.insert(res.begin(), '_');
+		}
+		if (is_keyword(res)) {
+			res += '_';
+		}
+		return res;
+	}
+
+	bool is_integer(const henifig::data_types& type) {
+		return type == henifig::ulonglong || type == henifig::longlong;
+	}
+
+	void merge(shape& into, const shape& from, const std::string& path);
+
+	shape describe(const henifig::value_t& value, const std::string& path) {
+		shape res;
+		res.type = static_cast <henifig::data_types>(value.index());
+		switch (res.type) {
+			case henifig::array: {
+				const henifig::value_array& items = value.get <henifig::value_array>();
+				for (size_t i = 0; i < items.size(); i++) {
+					const std::string item_path = path + '[' + std::to_string(i) + ']';
+					if (items[i].index() == henifig::declaration) {
+						continue;
+					}
+					shape item = describe(items[i], item_path);
+					if (res.items.empty()) {
+						res.items.push_back(std::move(item));
+					}
+					else {
+						merge(res.items[0], item, item_path);
+					}
+				}
+				break;
+			}
+			case henifig::map: {
+				std::set <std::string> names;
+				for (const auto& [key, item] : value.get <henifig::value_map>()) {
+					if (item.index() == henifig::declaration) {
+						continue;
+					}
+					const std::string item_path = path + '.' + std::string(key.view());
+					shape field = describe(item, item_path);
+					field.key = key.view();
+					field.field = identifier(field.key);
+					if (!names.insert(field.field).second) {
+						fail(item_path, "the key makes the same field name as another one, `" + field.field + '`');
+					}
+					res.fields.push_back(std::move(field));
+				}
+				break;
+			}
+			default: {
+			}
+		}
+		return res;
+	}
+
+	/**
+	 * @brief Widen the shape of the items of an array to fit another one: integers and floats make a double,
+	 * the items of arrays are merged and the fields of maps are joined.
+	 */
+	void merge(shape& into, const shape& from, const std::string& path) {
+		if (into.type != from.type) {
+			if (is_integer(into.type) && is_integer(from.type)) {
+				into.type = henifig::longlong;
+				return;
+			}
+			if ((into.type == henifig::floating || is_integer(into.type)) && (from.type == henifig::floating || is_integer(from.type))) {
+				into.type = henifig::floating;
+				return;
+			}
+			fail(path, "the items of an array are of different types");
+		}
+		if (into.type == henifig::array && !from.items.empty()) {
+			if (into.items.empty()) {
+				into.items = from.items;
+			}
+			else {
+				merge(into.items[0], from.items[0], path + "[]");
+			}
+		}
+		if (into.type == henifig::map) {
+			for (const shape& field : from.fields) {
+				bool found = false;
+				for (shape& existing : into.fields) {
+					if (existing.key == field.key) {
+						merge(existing, field, path + '.' + field.key);
+						found = true;
+						break;
+					}
+				}
+				if (!found) {
+					for (const shape& existing : into.fields) {
+						if (existing.field == field.field) {
+							fail(path + '.' + field.key, "the key makes the same field name as another one, `" + field.field + '`');
+						}
+					}
+					into.fields.push_back(field);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Name the structs of the maps after their fields and number every value the loader can write.
+	 */
+	void prepare(shape& s, const std::string& path, const std::string& type_name, const std::string& expr, int& next_slot) {
+		s.slot = next_slot++;
+		s.expr = expr;
+		switch (s.type) {
+			case henifig::array: {
+				if (s.items.empty()) {
+					fail(path, "an array with no items doesn't tell the type of its items");
+				}
+				shape& item = s.items[0];
+				item.element = true;
+				item.parent_expr = expr;
+				prepare(item, path + "[]", type_name, expr + ".back()", next_slot);
+				break;
+			}
+			case henifig::map: {
+				s.type_name = type_name;
+				std::set <std::string> names;
+				for (shape& field : s.fields) {
+					names.insert(field.field);
+				}
+				for (shape& field : s.fields) {
+					field.parent_expr = expr;
+					prepare(field, path + '.' + field.key, field.field + (field.type == henifig::array ? "_item" : "_t"), expr + '.' + field.field, next_slot);
+					if (!field.type_name.empty() && names.count(field.type_name)) {
+						fail(path + '.' + field.key, "the name of its struct, `" + field.type_name + "`, is taken by a field");
+					}
+				}
+				break;
+			}
+			default: {
+			}
+		}
+		if (s.type == henifig::array) {
+			s.type_name = s.items[0].type_name;
+		}
+	}
+
+	std::string escape(const std::string_view text, const char quote) {
+		std::string res;
+		res += quote;
+		for (const char c : text) {
+			const auto byte = static_cast <unsigned char>(c);
+			if (c == quote || c == '\\') {
+				res += '\\';
+				res += c;
+			}
+			else if (byte < 0x20 || byte >= 0x7F) {
+				char octal[5];
+				std::snprintf(octal, sizeof(octal), "\\%03o", byte);
+				res += octal;
+			}
+			else {
+				res += c;
+			}
+		}
+		res += quote;
+		return res;
+	}
+
+	std::string cpp_type(const shape& s) {
+		switch (s.type) {
+			case henifig::string: {
+				return "std::string";
+			}
+			case henifig::character: {
+				return "char";
+			}
+			case henifig::floating: {
+				return "double";
+			}
+			case henifig::ulonglong: {
+				return "unsigned long long";
+			}
+			case henifig::longlong: {
+				return "long long";
+			}
+			case henifig::boolean: {
+				return "bool";
+			}
+			case henifig::array: {
+				return "std::vector <" + cpp_type(s.items[0]) + '>';
+			}
+			default: {
+				return s.type_name;
+			}
+		}
+	}
+
+	std::string literal(const henifig::value_t& value, const shape& s) {
+		switch (s.type) {
+			case henifig::string: {
+				return escape(value.get <std::string>(), '"');
+			}
+			case henifig::character: {
+				const char c = value.get <char>();
+				return escape(std::string_view(&c, 1), '\'');
+			}
+			case henifig::floating: {
+				double x;
+				switch (value.index()) {
+					case henifig::ulonglong: {
+						x = static_cast <double>(value.get <unsigned long long>());
+						break;
+					}
+					case henifig::longlong: {
+						x = static_cast <double>(value.get <long long>());
+						break;
+					}
+					default: {
+						x = value.get <double>();
+					}
+				}
+				char buffer[32];
+				std::snprintf(buffer, sizeof(buffer), "%.17g", x);
+				std::string res = buffer;
+				if (res.find_first_of(".e") == std::string::npos) {
+					res += ".0";
+				}
+				return res;
+			}
+			case henifig::ulonglong: {
+				return std::to_string(value.get <unsigned long long>()) + "ULL";
+			}
+			case henifig::longlong: {
+				if (value.index() == henifig::ulonglong) {
+					return std::to_string(value.get <unsigned long long>()) + "LL";
+				}
+				const long long x = value.get <long long>();
+				if (x == std::numeric_limits <long long>::min()) {
+					return "(-9223372036854775807LL - 1)";
+				}
+				return std::to_string(x) + "LL";
+			}
+			case henifig::boolean: {
+				return value.get <bool>() ? "true" : "false";
+			}
+			case henifig::array: {
+				std::string res = "{";
+				for (const henifig::value_t& item : value.get <henifig::value_array>()) {
+					if (item.index() == henifig::declaration) {
+						continue;
+					}
+					res += res.size() > 1 ? ", " : "";
+					res += literal(item, s.items[0]);
+				}
+				return res + '}';
+			}
+			default: {
+				std::string res = "{";
+				for (const shape& field : s.fields) {
+					res += res.size() > 1 ? ", " : "";
+					const henifig::value_t* item = value.find(field.key);
+					res += item && item->index() != henifig::declaration ? literal(*item, field) : "{}";
+				}
+				return res + '}';
+			}
+		}
+	}
+
+	class writer {
+		std::ostringstream out;
+		size_t depth{};
+	public:
+		writer& line(const std::string& text = "") {
+			if (!text.empty()) {
+				if (text[0] == '}') {
+					depth--;
+				}
+				// Access specifiers sit with their class.
+				out << std::string(text == "public:" ? depth - 1 : depth, '\t');
+			}
+			out << text << '\n';
+			if (!text.empty() && text.back() == '{') {
+				depth++;
+			}
+			return *this;
+		}
+		[[nodiscard]] std::string str() const {
+			return out.str();
+		}
+	};
+
+	/**
+	 * @brief The struct of a map. Its members get the values of the sample as defaults unless it's an array item,
+	 * whose sample values go in the initializer of the array instead.
+	 */
+	void write_struct(writer& w, const std::string& name, const std::vector <shape>& fields, const std::vector <const henifig::value_t*>& samples) {
+		w.line("struct " + name + " {");
+		for (size_t i = 0; i < fields.size(); i++) {
+			const shape* inner = &fields[i];
+			while (inner->type == henifig::array) {
+				inner = &inner->items[0];
+			}
+			if (inner->type == henifig::map) {
+				std::vector <const henifig::value_t*> inner_samples(inner->fields.size());
+				if (inner == &fields[i] && samples[i]) {
+					for (size_t j = 0; j < inner->fields.size(); j++) {
+						inner_samples[j] = samples[i]->find(inner->fields[j].key);
+					}
+				}
+				write_struct(w, fields[i].type_name, inner->fields, inner_samples);
+			}
+		}
+		for (size_t i = 0; i < fields.size(); i++) {
+			const shape& field = fields[i];
+			std::string member = cpp_type(field) + ' ' + field.field;
+			if (samples[i] && field.type != henifig::map) {
+				member += " = " + literal(*samples[i], field);
+			}
+			else if (!samples[i] && field.type != henifig::map && field.type != henifig::array && field.type != henifig::string) {
+				member += "{}";
+			}
+			w.line(member + ';');
+		}
+		w.line("};");
+	}
+
+	void collect(std::vector <const shape*>& all, const shape& s) {
+		all.push_back(&s);
+		for (const shape& field : s.fields) {
+			collect(all, field);
+		}
+		for (const shape& item : s.items) {
+			collect(all, item);
+		}
+	}
+
+	/**
+	 * @brief A lookup of names by length first, then by their text.
+	 */
+	void write_lookup(writer& w, const std::vector <shape>& fields) {
+		std::vector <size_t> sizes;
+		for (const shape& field : fields) {
+			if (std::find(sizes.begin(), sizes.end(), field.key.size()) == sizes.end()) {
+				sizes.push_back(field.key.size());
+			}
+		}
+		w.line("switch (name.size()) {");
+		for (const size_t size : sizes) {
+			w.line("case " + std::to_string(size) + ": {");
+			for (const shape& field : fields) {
+				if (field.key.size() == size) {
+					w.line("if (name == " + escape(field.key, '"') + ") {");
+					w.line("return " + std::to_string(field.slot) + ';');
+					w.line("}");
+				}
+			}
+			w.line("break;");
+			w.line("}");
+		}
+		w.line("}");
+	}
+
+	std::string generate(const henifig::config_t& cfg, const std::string& source, const std::string& ns, const std::string& name) {
+		// The variables make the fields of the root, which is a map of its own.
+		shape root;
+		root.type = henifig::map;
+		std::set <std::string> names;
+		const std::vector <std::string>& vars = cfg.get_vars();
+		std::vector <const henifig::value_t*> samples;
+		for (size_t i = 0; i < vars.size(); i++) {
+			const henifig::value_t& value = cfg.get_value(i);
+			if (value.index() == henifig::declaration) {
+				continue;
+			}
+			shape field = describe(value, vars[i]);
+			field.key = vars[i];
+			field.field = identifier(vars[i]);
+			if (!names.insert(field.field).second) {
+				fail(vars[i], "the variable makes the same field name as another one, `" + field.field + '`');
+			}
+			root.fields.push_back(std::move(field));
+			samples.push_back(&value);
+		}
+		int next_slot = 1;
+		root.slot = next_slot++;
+		for (shape& field : root.fields) {
+			field.parent_expr = "out";
+			prepare(field, field.key, field.field + (field.type == henifig::array ? "_item" : "_t"), "out." + field.field, next_slot);
+			if (!field.type_name.empty() && names.count(field.type_name)) {
+				fail(field.key, "the name of its struct, `" + field.type_name + "`, is taken by a field");
+			}
+		}
+		std::vector <const shape*> all;
+		for (const shape& field : root.fields) {
+			collect(all, field);
+		}
+		const std::string loader = name + "_loader";
+
+		writer w;
+		w.line("// Generated by henifig-gen from " + source + ". Don't edit, regenerate it instead.");
+		w.line();
+		w.line("#pragma once");
+		w.line();
+		w.line("#include <string>");
+		w.line("#include <string_view>");
+		w.line("#include <vector>");
+		w.line();
+		w.line("#include \"henifig/exception.hpp\"");
+		w.line("#include \"henifig/generated.hpp\"");
+		w.line("#include \"henifig/sax.hpp\"");
+		w.line();
+		if (!ns.empty()) {
+			w.line("namespace " + ns + " {");
+		}
+
+		write_struct(w, name, root.fields, samples);
+		w.line();
+
+		// The loader, which knows each value by the number of the field it goes in, 0 being one to skip.
+		w.line("class " + loader + " final : public henifig::sax_handler {");
+		w.line(name + "& out;");
+		w.line("int slot{};");
+		w.line("std::vector <int> frames;");
+		w.line();
+		w.line("static int field(const int parent, const std::string_view name) {");
+		w.line("switch (parent) {");
+		w.line("case " + std::to_string(root.slot) + ": {");
+		write_lookup(w, root.fields);
+		w.line("break;");
+		w.line("}");
+		for (const shape* s : all) {
+			if (s->type == henifig::map && !s->fields.empty()) {
+				w.line("case " + std::to_string(s->slot) + ": {");
+				write_lookup(w, s->fields);
+				w.line("break;");
+				w.line("}");
+			}
+		}
+		w.line("}");
+		w.line("return 0;");
+		w.line("}");
+		w.line("static int item(const int array) {");
+		w.line("switch (array) {");
+		for (const shape* s : all) {
+			if (s->type == henifig::array) {
+				w.line("case " + std::to_string(s->slot) + ": {");
+				w.line("return " + std::to_string(s->items[0].slot) + ';');
+				w.line("}");
+			}
+		}
+		w.line("}");
+		w.line("return 0;");
+		w.line("}");
+		w.line("henifig::error_codes close() {");
+		w.line("frames.pop_back();");
+		w.line("slot = frames.empty() ? 0 : item(frames.back());");
+		w.line("return henifig::OK;");
+		w.line("}");
+		w.line("public:");
+		w.line("explicit " + loader + '(' + name + "& out) : out(out) {}");
+		w.line("henifig::error_codes on_var(const std::string_view name) override {");
+		w.line("slot = field(" + std::to_string(root.slot) + ", name);");
+		w.line("return henifig::OK;");
+		w.line("}");
+		w.line("henifig::error_codes on_key(const std::string_view key) override {");
+		w.line("slot = field(frames.back(), key);");
+		w.line("return henifig::OK;");
+		w.line("}");
+		w.line("henifig::error_codes on_scalar(const henifig::scalar_t& x) override {");
+		w.line("bool fits = true;");
+		w.line("switch (slot) {");
+		w.line("case 0: {");
+		w.line("break;");
+		w.line("}");
+		for (const shape* s : all) {
+			if (s->type != henifig::array && s->type != henifig::map) {
+				w.line("case " + std::to_string(s->slot) + ": {");
+				const std::string target = s->element ? s->parent_expr + ".emplace_back()" : s->expr;
+				w.line("fits = henifig::generated::assign(x, " + target + ");");
+				w.line("break;");
+				w.line("}");
+			}
+		}
+		w.line("default: {");
+		w.line("fits = x.index() == henifig::declaration;");
+		w.line("}");
+		w.line("}");
+		w.line("slot = frames.empty() ? 0 : item(frames.back());");
+		w.line("return fits ? henifig::OK : henifig::TYPE_MISMATCH;");
+		w.line("}");
+		for (const henifig::data_types type : {henifig::array, henifig::map}) {
+			w.line(std::string("henifig::error_codes on_") + (type == henifig::array ? "array" : "map") + "_begin() override {");
+			w.line("switch (slot) {");
+			w.line("case 0: {");
+			w.line("break;");
+			w.line("}");
+			for (const shape* s : all) {
+				if (s->type == type) {
+					w.line("case " + std::to_string(s->slot) + ": {");
+					if (s->element) {
+						w.line(s->parent_expr + ".emplace_back();");
+					}
+					else if (type == henifig::array) {
+						w.line(s->expr + ".clear();");
+					}
+					w.line("break;");
+					w.line("}");
+				}
+			}
+			w.line("default: {");
+			w.line("return henifig::TYPE_MISMATCH;");
+			w.line("}");
+			w.line("}");
+			w.line("frames.push_back(slot);");
+			w.line(type == henifig::array ? "slot = item(slot);" : "slot = 0;");
+			w.line("return henifig::OK;");
+			w.line("}");
+			w.line(std::string("henifig::error_codes on_") + (type == henifig::array ? "array" : "map") + "_end() override {");
+			w.line("return close();");
+			w.line("}");
+		}
+		w.line("};");
+		w.line();
+
+		w.line("/**");
+		w.line(" * @brief Read a config into a " + name + ". Whatever it doesn't have keeps its value and");
+		w.line(" * whatever isn't in the struct is skipped; @include directives aren't followed.");
+		w.line(" * @return The first error found, TYPE_MISMATCH for a value which doesn't fit its field.");
+		w.line(" */");
+		w.line("inline henifig::parse_report load(const std::string_view content, " + name + "& out) {");
+		w.line(loader + " loader(out);");
+		w.line("henifig::sax_parser parser(loader);");
+		w.line("return parser.parse(content);");
+		w.line("}");
+		w.line();
+		w.line("/**");
+		w.line(" * @brief Read a config into a new " + name + ", starting from the defaults.");
+		w.line(" * @exception henifig::parse_exception If the config is broken or a value doesn't fit its field.");
+		w.line(" */");
+		w.line("inline " + name + " load_" + name + "(const std::string_view content) {");
+		w.line(name + " res;");
+		w.line("if (const henifig::parse_report report = load(content, res); report.is_error()) {");
+		w.line("throw henifig::parse_exception(report);");
+		w.line("}");
+		w.line("return res;");
+		w.line("}");
+		if (!ns.empty()) {
+			w.line("}");
+		}
+		return w.str();
+	}
+}
+
+int main(int argc, char** argv) {
+	std::vector <std::string> positional;
+	std::string ns, name;
+	for (int i = 1; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		if ((arg == "--namespace" || arg == "--struct") && i + 1 < argc) {
+			(arg == "--namespace" ? ns : name) = argv[++i];
+		}
+		else {
+			positional.emplace_back(arg);
+		}
+	}
+	if (positional.size() != 2) {
+		std::cerr << "usage: henifig-gen <sample.hfg> <output.hpp> [--namespace <name>] [--struct <name>]\n";
+		return 2;
+	}
+	const std::string& input = positional[0];
+	const std::string& output = positional[1];
+	if (name.empty()) {
+		const size_t slash = input.find_last_of("/\\");
+		std::string stem = input.substr(slash == std::string::npos ? 0 : slash + 1);
+		stem = stem.substr(0, stem.find('.'));
+		name = identifier(stem);
+	}
+	std::string header;
+	try {
+		const henifig::config_t cfg(input);
+		header = generate(cfg, positional[0].substr(positional[0].find_last_of("/\\") + 1), ns, name);
+	}
+	catch (const std::exception& e) {
+		std::cerr << "henifig-gen: " << input << ": " << e.what() << '\n';
+		return 1;
+	}
+	// Leave the header alone if nothing changed so what includes it isn't rebuilt.
+	{
+		std::ifstream existing(output, std::ios::binary);
+		std::ostringstream current;
+		current << existing.rdbuf();
+		if (existing && current.str() == header) {
+			return 0;
+		}
+	}
+	std::ofstream file(output, std::ios::binary | std::ios::trunc);
+	file << header;
+	if (!file) {
+		std::cerr << "henifig-gen: couldn't write " << output << '\n';
+		return 1;
+	}
+	return 0;
+}